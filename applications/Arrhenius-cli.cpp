@@ -1,7 +1,13 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 #include <numeric>
+#include <regex>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 #include <boost/filesystem.hpp>
 
@@ -17,13 +23,36 @@ using namespace boost::multiprecision;
 #include <libArrhenius/version.h>
 #include <libArrhenius/Arrhenius.hpp>
 #include <libArrhenius/Utils/GenerateOutputFilename.hpp>
+#include <libArrhenius/Utils/BoundedQueue.hpp>
 
 namespace po = boost::program_options;
 using namespace std;
 
+// the precision used by the calc-* commands is selected at compile time
+// with the ARRHENIUS_CLI_PRECISION cmake option.
+#if defined(ARRHENIUS_CLI_PRECISION_DOUBLE)
+typedef double DataType;
+typedef libArrhenius::Trapezoid IntegrationMethod;
+#elif defined(ARRHENIUS_CLI_PRECISION_LONG_DOUBLE)
+typedef long double DataType;
+typedef libArrhenius::Trapezoid IntegrationMethod;
+#elif defined(ARRHENIUS_CLI_PRECISION_MIXED)
 typedef cpp_dec_float_100 DataType;
+typedef libArrhenius::MixedPrecision IntegrationMethod;
+#else
+typedef cpp_dec_float_100 DataType;
+typedef libArrhenius::Trapezoid IntegrationMethod;
+#endif
 typedef cpp_dec_float_100 HPDataType; // high precision data type
 
+// the integrator used by calc-damage. its parallel threshold is calibrated for this machine
+// the first time it runs, except for the mixed precision method, which is always serial.
+#if defined(ARRHENIUS_CLI_PRECISION_MIXED)
+typedef libArrhenius::ModifiedArrheniusIntegral<DataType,IntegrationMethod> DamageIntegrator;
+#else
+typedef libArrhenius::AutoTuned< libArrhenius::ModifiedArrheniusIntegral<DataType,IntegrationMethod> > DamageIntegrator;
+#endif
+
 namespace std {
   /* std::string to_string(cpp_dec_float_100 val) */
   /* {return static_cast<std::string>( val ); } */
@@ -63,6 +92,184 @@ void print_manual()
 }
 
 
+// directories given on the command line are replaced by the (sorted) list of regular files below them
+// whose names match the regex. files given directly are always included.
+std::vector<std::string> expand_files( std::vector<std::string> const &args, std::string const &match = ".*" )
+{
+  std::regex re(match);
+  std::vector<std::string> files;
+  for( auto arg : args )
+  {
+    if( !boost::filesystem::is_directory(arg) )
+    {
+      files.push_back(arg);
+      continue;
+    }
+
+    std::vector<std::string> found;
+    for( auto const &entry : boost::filesystem::recursive_directory_iterator(arg) )
+      if( boost::filesystem::is_regular_file(entry.status()) && std::regex_match( entry.path().filename().string(), re ) )
+        found.push_back( entry.path().string() );
+    std::sort( found.begin(), found.end() );
+    files.insert( files.end(), found.begin(), found.end() );
+  }
+  return files;
+}
+
+// these give the same text as operator<< on a default formatted stream, but
+// append to a buffer so that a whole profile can be written with one call.
+inline void format_value( std::string &buffer, double v )
+{
+  char s[32];
+  int len = std::snprintf( s, sizeof(s), "%g", v );
+  buffer.append( s, len );
+}
+inline void format_value( std::string &buffer, long double v )
+{
+  char s[48];
+  int len = std::snprintf( s, sizeof(s), "%Lg", v );
+  buffer.append( s, len );
+}
+template<typename Real>
+void format_value( std::string &buffer, Real const &v )
+{
+  static thread_local std::ostringstream ss;
+  ss.str("");
+  ss << v;
+  buffer += ss.str();
+}
+
+template<typename Real>
+void format_profile( std::string &buffer, std::vector<Real> const &x, std::vector<Real> const &y )
+{
+  for(size_t i = 0; i < x.size(); i++)
+  {
+    format_value( buffer, x[i] );
+    buffer += ' ';
+    format_value( buffer, y[i] );
+    buffer += '\n';
+  }
+}
+
+/** The format and write stages of a streaming calc-* command.
+ *
+ * The compute stage (the caller) pushes a result for each profile. The results are formatted on one
+ * thread and written on another, in the order they were pushed. Each stage is connected to the next by a
+ * bounded queue, so if writing falls behind, the stages before it wait instead of buffering results.
+ */
+class OutputPipeline
+{
+  public:
+    struct Result
+    {
+      std::string summary;          // printed to stdout
+      std::string output_filename;  // the profile is written here, unless this is empty
+      std::vector<DataType> t, y;
+    };
+
+  protected:
+    struct Formatted
+    {
+      std::string summary;
+      std::string output_filename;
+      std::string output;
+    };
+
+    RUC::BoundedQueue<Result> results;
+    RUC::BoundedQueue<Formatted> formatted;
+    std::thread formatter, writer;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    bool finished = false;
+
+  public:
+    OutputPipeline( size_t capacity )
+    :results(capacity), formatted(capacity)
+    {
+      formatter = std::thread( [this](){ stage( [this](){ format(); } ); } );
+      writer = std::thread( [this](){ stage( [this](){ write(); } ); } );
+    }
+
+    ~OutputPipeline()
+    {
+      if( !finished )
+      {
+        results.close();
+        formatted.close();
+        formatter.join();
+        writer.join();
+      }
+    }
+
+    void push( Result result )
+    {
+      if( !results.push( std::move(result) ) )
+        finish(); // a stage failed, this will rethrow its exception.
+    }
+
+    /** Waits for all of the results to be written. */
+    void finish()
+    {
+      results.close();
+      formatter.join();
+      writer.join();
+      finished = true;
+      if( error )
+        std::rethrow_exception(error);
+    }
+
+  protected:
+    // if a stage fails, shut the pipeline down so the other stages don't wait forever.
+    template<typename F>
+    void stage( F f )
+    {
+      try {
+        f();
+      } catch( ... ) {
+        {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if( !error )
+            error = std::current_exception();
+        }
+        results.close();
+        formatted.close();
+      }
+    }
+
+    void format()
+    {
+      Result result;
+      while( results.pop(result) )
+      {
+        Formatted f;
+        f.summary = std::move(result.summary);
+        f.output_filename = std::move(result.output_filename);
+        if( !f.output_filename.empty() )
+          format_profile( f.output, result.t, result.y );
+        if( !formatted.push( std::move(f) ) )
+          return;
+      }
+      formatted.close();
+    }
+
+    void write()
+    {
+      Formatted f;
+      while( formatted.pop(f) )
+      {
+        std::cout << f.summary << "\n";
+        if( f.output_filename.empty() )
+          continue;
+        std::ofstream out( f.output_filename, std::ios::binary );
+        out.write( f.output.data(), f.output.size() );
+        if( !out )
+          throw std::runtime_error("ERROR: Could not write '"+f.output_filename+"'.");
+      }
+      std::cout << std::flush;
+    }
+};
+
+
 
 
 
@@ -85,10 +292,12 @@ int calc_threshold_cmd( std::string prog, std::string cmd, std::vector<std::stri
       ("Omega", po::value<DataType>()->default_value(1), "Compute threshold corresponding to the value of Omega.")
       ("write-threshold-profiles,w", "Write the threshold thermal profile to disk.")
       ("output-filename,o", po::value<std::string>()->default_value("fmt:{ifn}.threshold"), "Output filename.")
+      ("match", po::value<std::string>()->default_value(".*"), "Only read files whose names match this regex when searching directories.")
+      ("pipeline", "Stream the profiles through separate read, compute, format and write stages. Memory use does not depend on the number of files.")
       ;
     po::options_description arg_options("Arguments");
     arg_options.add_options()
-      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile files to analyze.") // an option that can be given multiple times with each argument getting stored in a vector.
+      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile files to analyze. Directories are searched recursively.") // an option that can be given multiple times with each argument getting stored in a vector.
       ;
 
     po::options_description all_options("Options");
@@ -110,28 +319,103 @@ int calc_threshold_cmd( std::string prog, std::string cmd, std::vector<std::stri
     }
 
 
-    libArrhenius::ThresholdCalculator< libArrhenius::ModifiedArrheniusIntegral<DataType> > calc;
+    libArrhenius::ThresholdCalculator< libArrhenius::ModifiedArrheniusIntegral<DataType,IntegrationMethod> > calc;
     calc.setA( vm["A"].as<DataType>() );
     calc.setEa( vm["Ea"].as<DataType>() );
     calc.setExponent( vm["n"].as<DataType>() );
     calc.setThresholdOmega( vm["Omega"].as<DataType>() );
     
-    std::cout<< "filename | Omega | threshold" << std::endl;
-    for( auto file : vm["files"].as<std::vector<std::string>>() )
+    libArrhenius::BatchIntegrator< libArrhenius::ModifiedArrheniusIntegral<DataType,IntegrationMethod> > integrate;
+    integrate.setA( vm["A"].as<DataType>() );
+    integrate.setEa( vm["Ea"].as<DataType>() );
+    integrate.setExponent( vm["n"].as<DataType>() );
+
+    std::vector<std::string> files = expand_files( vm["files"].as<std::vector<std::string>>(), vm["match"].as<std::string>() );
+
+    if( vm.count("pipeline") )
     {
-      int n;
-      DataType *t, *T;
-
-      if( !boost::filesystem::exists(file) )
-        throw std::runtime_error("ERROR: '"+file+"' does not exist.");
-      std::ifstream in(file.c_str());
-      RUC::ReadFunction(in, t, T, n);
-      in.close();
+      // the profiles are computed in batches, so that the thresholds can still be calculated in
+      // parallel, and the loader reads the next batch while the current one is computed.
+      size_t batch_size = 4*std::max( 1u, std::thread::hardware_concurrency() );
+      libArrhenius::ProfileLoader<DataType> loader( files, 0, batch_size );
+      OutputPipeline output( batch_size );
+      std::vector<libArrhenius::ProfileLoader<DataType>::Profile> batch;
+
+      auto compute = [&](){
+        libArrhenius::ProfileSet<DataType> profiles;
+        for( auto const &p : batch )
+          profiles.addProfile( p.t.size(), p.t.data(), p.T.data() );
+        auto Omegas = integrate(profiles);
+        auto Thresholds = calc(profiles);
+
+        for( size_t j = 0; j < batch.size(); ++j )
+        {
+          OutputPipeline::Result result;
+          std::ostringstream summary;
+          summary << batch[j].filename << " | " << Omegas[j] << " | " << Thresholds[j];
+          result.summary = summary.str();
+          if( vm.count("write-threshold-profiles") )
+          {
+            result.output_filename = RUC::GenerateOutputFilename(batch[j].filename,vm["output-filename"].as<std::string>());
+            result.t = std::move(batch[j].t);
+            result.y = std::move(batch[j].T);
+            DataType T0 = result.y[0];
+            for( auto &T : result.y )
+              T = Thresholds[j]*(T - T0) + T0;
+          }
+          output.push( std::move(result) );
+        }
+        batch.clear();
+      };
+
+      std::cout<< "filename | Omega | threshold" << std::endl;
+      libArrhenius::ProfileLoader<DataType>::Profile profile;
+      while( loader.next(profile) )
+      {
+        // add offset temp
+        DataType T0 = vm["T0"].as<DataType>();
+        std::transform( profile.T.begin(), profile.T.end(), profile.T.begin(), [&T0]( DataType const &T ){ return DataType(T + T0); } );
+        batch.push_back( std::move(profile) );
+        if( batch.size() == batch_size )
+          compute();
+      }
+      compute();
+      output.finish();
+
+      return 0;
+    }
+
+    // read all of the profiles first so that the thresholds can be calculated in parallel.
+    // the files are read and parsed concurrently.
+    libArrhenius::ProfileSet<DataType> profiles;
+    // a binary profile file can hold several profiles, so keep the name of each one.
+    std::vector<std::string> names;
+    libArrhenius::ProfileLoader<DataType> loader( files );
+    libArrhenius::ProfileLoader<DataType>::Profile profile;
+    while( loader.next(profile) )
+    {
+      names.push_back(profile.filename);
+      int n = profile.t.size();
+      DataType *t = profile.t.data(), *T = profile.T.data();
+
       // add offset temp
       std::transform( T, T+n, T, std::bind2nd(std::plus<DataType>(), vm["T0"].as<DataType>()) );
 
-      auto Omega = calc.Omega(n,t,T);
-      auto Threshold = calc(n,t,T);
+      profiles.addProfile(n,t,T);
+    }
+
+    auto Omegas = integrate(profiles);
+    auto Thresholds = calc(profiles);
+
+    std::cout<< "filename | Omega | threshold" << std::endl;
+    for( size_t j = 0; j < profiles.size(); ++j )
+    {
+      auto file = names[j];
+      size_t n = profiles.N(j);
+      DataType const *t = profiles.t(j);
+      DataType const *T = profiles.T(j);
+      auto Omega = Omegas[j];
+      auto Threshold = Thresholds[j];
 
       std::cout << file << " | " << Omega << " | " << Threshold << std::endl;
 
@@ -150,9 +434,6 @@ int calc_threshold_cmd( std::string prog, std::string cmd, std::vector<std::stri
         delete[] TT;
 
       }
-
-      delete[] t;
-      delete[] T;
     }
     
     return 0;
@@ -187,10 +468,11 @@ int calc_rate_cmd( std::string prog, std::string cmd, std::vector<std::string> &
       ("log", "Calculate the log of the rate instead.")
       ("output-filename,o", po::value<std::string>()->default_value("fmt:{ifn}.rate"), "Output filename.")
       ("write-rate-profiles,w", "Write the rate profile to disk.")
+      ("match", po::value<std::string>()->default_value(".*"), "Only read files whose names match this regex when searching directories.")
       ;
     po::options_description arg_options("Arguments");
     arg_options.add_options()
-      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile files to analyze.") // an option that can be given multiple times with each argument getting stored in a vector.
+      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile files to analyze. Directories are searched recursively.") // an option that can be given multiple times with each argument getting stored in a vector.
       ;
 
     po::options_description all_options("Options");
@@ -211,22 +493,21 @@ int calc_rate_cmd( std::string prog, std::string cmd, std::vector<std::string> &
       return 0;
     }
 
-    libArrhenius::ModifiedArrheniusIntegral<DataType> integrate;
+    libArrhenius::ModifiedArrheniusIntegral<DataType,IntegrationMethod> integrate;
     integrate.setA( vm["A"].as<DataType>() );
     integrate.setEa( vm["Ea"].as<DataType>() );
     integrate.setExponent( vm["n"].as<DataType>() );
 
 
-    for( auto file : vm["files"].as<std::vector<std::string>>() )
+    // the files are read and parsed on background threads while the loaded profiles are processed.
+    libArrhenius::ProfileLoader<DataType> loader( expand_files( vm["files"].as<std::vector<std::string>>(), vm["match"].as<std::string>() ) );
+    libArrhenius::ProfileLoader<DataType>::Profile profile;
+    while( loader.next(profile) )
     {
-      int n;
-      DataType *t, *T;
-
-      if( !boost::filesystem::exists(file) )
-        throw std::runtime_error("ERROR: '"+file+"' does not exist.");
-      std::ifstream in(file.c_str());
-      RUC::ReadFunction(in, t, T, n);
-      in.close();
+      std::string file = profile.filename;
+      int n = profile.t.size();
+      DataType *t = profile.t.data(), *T = profile.T.data();
+
       // add offset temp
       std::transform( T, T+n, T, std::bind2nd(std::plus<DataType>(), vm["T0"].as<DataType>()) );
 
@@ -269,9 +550,6 @@ int calc_rate_cmd( std::string prog, std::string cmd, std::vector<std::string> &
         out.close();
       }
 
-
-      delete[] t;
-      delete[] T;
     }
     
     return 0;
@@ -305,10 +583,12 @@ int calc_damage_cmd( std::string prog, std::string cmd, std::vector<std::string>
       ("T0", po::value<DataType>()->default_value(0), "Offset temperature that will be added to all thermal profiles.")
       ("output-filename,o", po::value<std::string>()->default_value("fmt:{ifn}.damage"), "Output filename.")
       ("write-damage-profiles,w", "Write the damage profiles to disk.")
+      ("match", po::value<std::string>()->default_value(".*"), "Only read files whose names match this regex when searching directories.")
+      ("pipeline", "Stream the profiles through separate read, compute, format and write stages. Memory use does not depend on the number of files.")
       ;
     po::options_description arg_options("Arguments");
     arg_options.add_options()
-      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile files to analyze.") // an option that can be given multiple times with each argument getting stored in a vector.
+      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile files to analyze. Directories are searched recursively.") // an option that can be given multiple times with each argument getting stored in a vector.
       ;
 
     po::options_description all_options("Options");
@@ -329,23 +609,72 @@ int calc_damage_cmd( std::string prog, std::string cmd, std::vector<std::string>
       return 0;
     }
 
-    libArrhenius::ModifiedArrheniusIntegral<DataType> integrate;
+    DamageIntegrator integrate;
     integrate.setA( vm["A"].as<DataType>() );
     integrate.setEa( vm["Ea"].as<DataType>() );
     integrate.setExponent( vm["n"].as<DataType>() );
 
 
+    std::vector<std::string> files = expand_files( vm["files"].as<std::vector<std::string>>(), vm["match"].as<std::string>() );
+
+    if( vm.count("pipeline") )
+    {
+      libArrhenius::ProfileLoader<DataType> loader( files );
+      OutputPipeline output( 4*std::max( 1u, std::thread::hardware_concurrency() ) );
+      libArrhenius::DamageAccumulator<DataType> damage( vm["A"].as<DataType>(), vm["Ea"].as<DataType>(), vm["n"].as<DataType>() );
+
+      std::cout<< "filename | Omega" << std::endl;
+      libArrhenius::ProfileLoader<DataType>::Profile profile;
+      while( loader.next(profile) )
+      {
+        size_t n = profile.t.size();
+        // add offset temp
+        DataType T0 = vm["T0"].as<DataType>();
+        std::transform( profile.T.begin(), profile.T.end(), profile.T.begin(), [&T0]( DataType const &T ){ return DataType(T + T0); } );
+
+        OutputPipeline::Result result;
+        DataType Omega;
+        if( vm.count("write-damage-profiles") )
+        {
+          // the damage profile is accumulated in one pass. like the regular mode, the value
+          // written for each time is the damage from the samples before it. the reported Omega
+          // comes from the same accumulator, so that it is consistent with the profile (the
+          // accumulator uses the trapezoid rule in DataType, whatever the integration method).
+          result.output_filename = RUC::GenerateOutputFilename(profile.filename,vm["output-filename"].as<std::string>());
+          result.y.resize(n);
+          damage.reset();
+          for(size_t i = 0; i < n; i++)
+          {
+            result.y[i] = damage.Omega();
+            damage.add( profile.t[i], profile.T[i] );
+          }
+          Omega = damage.Omega();
+          result.t = std::move(profile.t);
+        }
+        else
+        {
+          Omega = integrate(n,profile.t.data(),profile.T.data());
+        }
+        std::ostringstream summary;
+        summary << profile.filename << " | " << Omega;
+        result.summary = summary.str();
+        output.push( std::move(result) );
+      }
+      output.finish();
+
+      return 0;
+    }
+
     std::cout<< "filename | Omega" << std::endl;
-    for( auto file : vm["files"].as<std::vector<std::string>>() )
+    // the files are read and parsed on background threads while the loaded profiles are processed.
+    libArrhenius::ProfileLoader<DataType> loader( files );
+    libArrhenius::ProfileLoader<DataType>::Profile profile;
+    while( loader.next(profile) )
     {
-      int n;
-      DataType *t, *T;
-
-      if( !boost::filesystem::exists(file) )
-        throw std::runtime_error("ERROR: '"+file+"' does not exist.");
-      std::ifstream in(file.c_str());
-      RUC::ReadFunction(in, t, T, n);
-      in.close();
+      std::string file = profile.filename;
+      int n = profile.t.size();
+      DataType *t = profile.t.data(), *T = profile.T.data();
+
       // add offset temp
       std::transform( T, T+n, T, std::bind2nd(std::plus<DataType>(), vm["T0"].as<DataType>()) );
 
@@ -362,9 +691,6 @@ int calc_damage_cmd( std::string prog, std::string cmd, std::vector<std::string>
         out.close();
       }
 
-
-      delete[] t;
-      delete[] T;
     }
     
     return 0;
@@ -396,10 +722,11 @@ int fit_cmd( std::string prog, std::string cmd, std::vector<std::string> &cmd_ar
       ("dT-uncertainty", po::value<HPDataType>(), "Uncertainty in temperature rise (in K).")
       ("Ea-min", po::value<HPDataType>(), "Minimum bound on Ea for methods that perform a search.")
       ("Ea-max", po::value<HPDataType>(), "Maximum bound on Ea for methods that perform a search.")
+      ("match", po::value<std::string>()->default_value(".*"), "Only read files whose names match this regex when searching directories.")
       ;
     po::options_description arg_options("Arguments");
     arg_options.add_options()
-      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile (in K vs. s) files to fit. These are ASSUMED to be threshold profiles.")
+      ("files"  , po::value<std::vector<std::string>>()->composing(), "Thermal profile (in K vs. s) files to fit. These are ASSUMED to be threshold profiles. Directories are searched recursively.")
       ;
 
     po::options_description all_options("Options");
@@ -439,26 +766,23 @@ int fit_cmd( std::string prog, std::string cmd, std::vector<std::string> &cmd_ar
 
     // read in thermal profiles
     std::cout << "Loading thermal profiles." << std::endl;
-    std::vector<std::shared_ptr<HPDataType>> ts,Ts;
+    std::vector<std::vector<HPDataType>> ts,Ts;
     std::vector<size_t> Ns;
-    for( auto file : vm["files"].as<std::vector<std::string>>() )
+    // a binary profile file can hold several profiles, so keep the name of each one.
+    std::vector<std::string> names;
+    // the files are read and parsed concurrently.
+    std::vector<std::string> files = expand_files( vm["files"].as<std::vector<std::string>>(), vm["match"].as<std::string>() );
+    libArrhenius::ProfileLoader<HPDataType> loader( files );
+    libArrhenius::ProfileLoader<HPDataType>::Profile profile;
+    while( loader.next(profile) )
     {
-      int n;
-      HPDataType *t, *T;
-
-      if( !boost::filesystem::exists(file) )
-        throw std::runtime_error("ERROR: '"+file+"' does not exist.");
-      std::ifstream in(file.c_str());
-      RUC::ReadFunction(in, t, T, n);
-      in.close();
       // add offset temp
-      std::transform( T, T+n, T, std::bind2nd(std::plus<HPDataType>(), vm["T0"].as<HPDataType>()) );
-
-      // we need to wrap these in shared_ptr's so we don't leak memory
-      Ns.push_back(n);
-      ts.push_back( std::shared_ptr<HPDataType>( t ) );
-      Ts.push_back( std::shared_ptr<HPDataType>( T ) );
+      std::transform( profile.T.begin(), profile.T.end(), profile.T.begin(), std::bind2nd(std::plus<HPDataType>(), vm["T0"].as<HPDataType>()) );
 
+      Ns.push_back(profile.t.size());
+      names.push_back(profile.filename);
+      ts.push_back( std::move(profile.t) );
+      Ts.push_back( std::move(profile.T) );
     }
 
 
@@ -513,7 +837,7 @@ int fit_cmd( std::string prog, std::string cmd, std::vector<std::string> &cmd_ar
 
       // now fit the profiles
       for( int i = 0; i < Ns.size(); ++i )
-        fit->addProfile( Ns[i], ts[i].get(), Ts[i].get() );
+        fit->addProfile( Ns[i], ts[i].data(), Ts[i].data() );
 
       if(vm.count("Ea-min"))
         fit->setMinEa( vm["Ea-min"].as<HPDataType>() );
@@ -531,15 +855,15 @@ int fit_cmd( std::string prog, std::string cmd, std::vector<std::string> &cmd_ar
         // add uncertainty to the thermal profiles and add them to the fitter
         for( int i = 0; i < Ns.size(); ++i )
         {
-          std::transform( Ts[i].get(), Ts[i].get()+Ns[i], Ts[i].get(), std::bind2nd(std::plus<HPDataType>(), vm["T0-uncertainty"].as<HPDataType>()) );
-          fit->addProfile( Ns[i], ts[i].get(), Ts[i].get() );
+          std::transform( Ts[i].data(), Ts[i].data()+Ns[i], Ts[i].data(), std::bind2nd(std::plus<HPDataType>(), vm["T0-uncertainty"].as<HPDataType>()) );
+          fit->addProfile( Ns[i], ts[i].data(), Ts[i].data() );
         }
 
         errors.push_back(fit->exec());
 
         // subtract the uncertainty back off the thermal profiles
         for( int i = 0; i < Ns.size(); ++i )
-          std::transform( Ts[i].get(), Ts[i].get()+Ns[i], Ts[i].get(), std::bind2nd(std::minus<HPDataType>(), vm["T0-uncertainty"].as<HPDataType>()) );
+          std::transform( Ts[i].data(), Ts[i].data()+Ns[i], Ts[i].data(), std::bind2nd(std::minus<HPDataType>(), vm["T0-uncertainty"].as<HPDataType>()) );
       }
 
       // propagate error for peak temperature rise if given
@@ -549,12 +873,12 @@ int fit_cmd( std::string prog, std::string cmd, std::vector<std::string> &cmd_ar
         // add uncertainty to the thermal profiles and add them to the fitter
         for( int i = 0; i < Ns.size(); ++i )
         {
-          HPDataType Tmax = *std::max_element( Ts[i].get(), Ts[i].get() + Ns[i] );
-          HPDataType scale = 1 + vm["dT-uncertainty"].as<HPDataType>()/(Tmax - Ts[i].get()[0]);
+          HPDataType Tmax = *std::max_element( Ts[i].data(), Ts[i].data() + Ns[i] );
+          HPDataType scale = 1 + vm["dT-uncertainty"].as<HPDataType>()/(Tmax - Ts[i].data()[0]);
           for( int j = 0; j < Ns[i]; j++)
-            Ts[i].get()[j] = Ts[i].get()[0] + scale*(Ts[i].get()[j] - Ts[i].get()[0]);
+            Ts[i].data()[j] = Ts[i].data()[0] + scale*(Ts[i].data()[j] - Ts[i].data()[0]);
 
-          fit->addProfile( Ns[i], ts[i].get(), Ts[i].get() );
+          fit->addProfile( Ns[i], ts[i].data(), Ts[i].data() );
         }
 
         errors.push_back(fit->exec());
@@ -562,10 +886,10 @@ int fit_cmd( std::string prog, std::string cmd, std::vector<std::string> &cmd_ar
         // subtract the uncertainty back off the thermal profiles
         for( int i = 0; i < Ns.size(); ++i )
         {
-          HPDataType Tmax = *std::max_element( Ts[i].get(), Ts[i].get() + Ns[i] );
-          HPDataType scale = 1 - vm["dT-uncertainty"].as<HPDataType>()/(Tmax - Ts[i].get()[0]);
+          HPDataType Tmax = *std::max_element( Ts[i].data(), Ts[i].data() + Ns[i] );
+          HPDataType scale = 1 - vm["dT-uncertainty"].as<HPDataType>()/(Tmax - Ts[i].data()[0]);
           for( int j = 0; j < Ns[i]; j++)
-            Ts[i].get()[j] = Ts[i].get()[0] + scale*(Ts[i].get()[j] - Ts[i].get()[0]);
+            Ts[i].data()[j] = Ts[i].data()[0] + scale*(Ts[i].data()[j] - Ts[i].data()[0]);
         }
       }
 
@@ -590,18 +914,18 @@ int fit_cmd( std::string prog, std::string cmd, std::vector<std::string> &cmd_ar
       std::cout<< "filename | Omega | threshold" << std::endl;
 
       // todo: should we add support for modified arrhenius?
-      libArrhenius::ThresholdCalculator< libArrhenius::ArrheniusIntegral<DataType> > calc;
+      libArrhenius::ThresholdCalculator< libArrhenius::ArrheniusIntegral<HPDataType> > calc;
       calc.setA( coefficients.A.get() );
       calc.setEa( coefficients.Ea.get() );
       //calc.setExponent( vm["n"].as<DataType>() );
       // what about support for omega != 1?
       //calc.setThresholdOmega( vm["Omega"].as<DataType>() );
       std::vector<HPDataType> Thresholds(Ns.size());
-      for( int i = 0; i < vm["files"].as<std::vector<std::string>>().size(); i++ )
+      for( size_t i = 0; i < Ns.size(); i++ )
       {
-        auto file = vm["files"].as<std::vector<std::string>>()[i];
-        auto Omega = calc.Omega(Ns[i],ts[i].get(),Ts[i].get());
-        auto Threshold = calc(Ns[i],ts[i].get(),Ts[i].get());
+        auto file = names[i];
+        auto Omega = calc.Omega(Ns[i],ts[i].data(),Ts[i].data());
+        auto Threshold = calc(Ns[i],ts[i].data(),Ts[i].data());
         std::cout << file << " | " << Omega << " | " << Threshold << std::endl;
         Thresholds[i] = Threshold;
       }
@@ -674,6 +998,7 @@ int main(int argc, const char** argv)
       ("version", "print library version.")
       ("manual",  "print manual.")
       ("verbose,v", po::value<int>()->default_value(0), "verbose level.") // an option that takes an argument, but has a default value.
+      ("stats", "print integration counts and the time spent in each phase of the calculation to stderr when the command finishes. Only available if libArrhenius was configured with LIBARRHENIUS_ENABLE_STATS.")
       ;
       
     // now define our arguments.
@@ -744,20 +1069,22 @@ int main(int argc, const char** argv)
 
 
 
+    int ret = 0;
     if( vm["command"].as<std::string>() == "calc-threshold" )
-      return calc_threshold_cmd( argv[0], "calc-threshold", cmd_args );
+      ret = calc_threshold_cmd( argv[0], "calc-threshold", cmd_args );
 
     if( vm["command"].as<std::string>() == "calc-rate" )
-      return calc_rate_cmd( argv[0], "calc-rate", cmd_args );
+      ret = calc_rate_cmd( argv[0], "calc-rate", cmd_args );
 
     if( vm["command"].as<std::string>() == "calc-damage" )
-      return calc_damage_cmd( argv[0], "calc-damage", cmd_args );
+      ret = calc_damage_cmd( argv[0], "calc-damage", cmd_args );
 
     if( vm["command"].as<std::string>() == "fit" )
-      return fit_cmd( argv[0], "fit", cmd_args );
+      ret = fit_cmd( argv[0], "fit", cmd_args );
 
-    
+    if( vm.count("stats") )
+      libArrhenius::Stats::report().print( std::cerr );
 
 
-    return 0;
+    return ret;
 }
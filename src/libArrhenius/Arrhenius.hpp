@@ -2,6 +2,14 @@
 #include "./Utils/ReadFunction.hpp"
 #include "./Integration/ArrheniusIntegral.hpp"
 #include "./Integration/ModifiedArrheniusIntegral.hpp"
+#include "./Integration/BatchIntegrator.hpp"
+#include "./Integration/AutoTune.hpp"
+#include "./Integration/DamageAccumulator.hpp"
+#include "./Profiles/ProfileSet.hpp"
+#include "./Profiles/PreparedProfile.hpp"
+#include "./Profiles/BinaryProfileFile.hpp"
+#include "./Profiles/ProfileLoader.hpp"
 #include "./Fitting/ArrheniusFit.hpp"
 #include "./Constants.hpp"
+#include "./Stats.hpp"
 
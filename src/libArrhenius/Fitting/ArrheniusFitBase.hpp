@@ -6,9 +6,15 @@
   * @author C.D. Clark III
   * @date 06/28/17
   */
+#include<exception>
+#include<limits>
 #include<boost/optional.hpp>
 #include<boost/log/trivial.hpp>
+#include<boost/math/tools/roots.hpp>
 #include"ArrheniusFitInterface.hpp"
+#include"../Integration/ArrheniusIntegral.hpp"
+#include"../Profiles/PreparedProfile.hpp"
+#include"../Stats.hpp"
 
 namespace libArrhenius {
 
@@ -53,6 +59,52 @@ class ArrheniusFitBase : public ArrheniusFitInterface<Real>
     boost::optional<Real> getMaxA( ) const { return maxA; }
 
   protected:
+    // the fits integrate every profile many times, so they work
+    // on prepared copies that only compute dt, 1/T, etc. once.
+    std::vector<PreparedProfile<Real>> prepareProfiles() const
+    {
+      std::vector<PreparedProfile<Real>> profiles(N.size());
+      for(size_t i = 0; i < N.size(); ++i)
+        profiles[i].prepare( N[i], t[i], T[i] );
+      return profiles;
+    }
+
+    // If Ea is too large, then the Arrhenius integral will
+    // return zero. The point at which this happens depends on the
+    // data type being used. Basically, higher-precision types can
+    // evaluate the integral at larger Ea's before reaching zero.
+    // So, we know Ea can't be larger than the smallest value that
+    // gives zero for the integral of any profile.
+    //
+    // returns that value for each profile. the profiles are searched in parallel, each
+    // with its own integrator. if the search fails for a profile, its error is stored
+    // in errors[i] instead (exceptions can't leave an OpenMP region).
+    std::vector<Real> EaUpperBounds( std::vector<PreparedProfile<Real>> const &profiles, std::vector<std::exception_ptr> &errors ) const
+    {
+      std::vector<Real> bounds(profiles.size());
+      errors.assign(profiles.size(), nullptr);
+      #pragma omp parallel for schedule(dynamic) if(profiles.size() > 1)
+      for(std::size_t i = 0; i < profiles.size(); ++i)
+      {
+        try {
+          ArrheniusIntegral<Real> integrator;
+          integrator.setA(1);
+          boost::math::tools::eps_tolerance<Real> tol( std::numeric_limits<Real>::digits - 3 );
+          boost::uintmax_t maxit = 100;
+          Real guess = 1e2; // a place to start
+          Real factor = 2;  // multiplication factor to use when searching for upper bound
+          auto range = boost::math::tools::bracket_and_solve_root( [&](Real Ea){
+              integrator.setEa(Ea);
+              LIBARRHENIUS_STATS_INTEGRATIONS(profiles[i].size(), 1);
+              return integrator(profiles[i]);}, guess, factor, false, tol, maxit );
+          LIBARRHENIUS_STATS_ADD(RootIterations, maxit);
+          bounds[i] = range.first;
+        } catch(...) {
+          errors[i] = std::current_exception();
+        }
+      }
+      return bounds;
+    }
 };
 
 }
@@ -9,6 +9,7 @@
 
 #include <Eigen/Dense>
 #include "../../Utils/LinearRegression.hpp"
+#include "../../Stats.hpp"
 
 namespace libArrhenius {
 
@@ -28,6 +29,7 @@ class ArrheniusFit<Real,ConstantTemperatureLinearRegression> : public ArrheniusF
     Return
     exec() const
     {
+      LIBARRHENIUS_STATS_TIMER(Fit);
       Return ret;
       ArrheniusIntegral<Real> integrator;
       std::vector<Real*> const &t = this->t;
@@ -9,6 +9,7 @@
 
 #include <Eigen/Dense>
 #include "../../Utils/LinearRegression.hpp"
+#include "../../Stats.hpp"
 
 namespace libArrhenius {
 
@@ -28,11 +29,11 @@ class ArrheniusFit<Real,EffectiveExposuresLinearRegression> : public ArrheniusFi
     Return
     exec() const
     {
+      LIBARRHENIUS_STATS_TIMER(Fit);
       Return ret;
       ArrheniusIntegral<Real> integrator;
-      std::vector<Real*> const &t = this->t;
-      std::vector<Real*> const &T = this->T;
       std::vector<size_t> const &N = this->N;
+      std::vector<PreparedProfile<Real>> const profiles = this->prepareProfiles();
 
 
       // construct effective exposure parameters for each profile
@@ -56,55 +57,52 @@ class ArrheniusFit<Real,EffectiveExposuresLinearRegression> : public ArrheniusFi
       }
       else
       {
+      LIBARRHENIUS_STATS_TIMER(UpperBoundSearch);
 
-      // If Ea is too large, then the Arrhenius integral will
-      // return zero. The point at which this happens depends on the
-      // data type being used. Basically, higher-precision types can
-      // evaluate the integral at larger Ea's before reaching zero.
-      // So, we know Ea can't be larger than the smallest value that
-      // gives zero for the integral. This gives us an initial upper bound on Ea.
+      // the integral vanishes for Ea larger than some value that depends on the profile and
+      // data type, so the smallest of these is an upper bound on Ea.
+      // the searches are independent, so they run in parallel.
+      std::vector<std::exception_ptr> errors;
+      std::vector<Real> bounds = this->EaUpperBounds( profiles, errors );
       for( size_t i = 0; i < N.size(); i++ )
       {
-        int prec = std::numeric_limits<Real>::digits - 3;
-        eps_tolerance<Real> tol( prec );
-        boost::uintmax_t maxit = 100;
-        Real guess = 1e2; // a place to start
-        Real factor = 2;  // multiplication factor to use when searching for upper bound
-        auto Ea_ub_range = bracket_and_solve_root( [&](Real Ea){
-            integrator.setEa(Ea);
-            integrator.setA(1);
-            return integrator(N[i],t[i],T[i]);}, guess, factor, false, tol, maxit );
+        if( errors[i] )
+          std::rethrow_exception( errors[i] );
         // use the smallest Ea for the upper bound.
-        if( i == 0 || Ea_ub_range.first < Ea_ub )
-          Ea_ub = Ea_ub_range.first;
+        if( i == 0 || bounds[i] < Ea_ub )
+          Ea_ub = bounds[i];
       }
       }
 
 
+      // We'll calculate (Ea,log(A)) pairs for every half decade
+      int emin = static_cast<int>(log10(Ea_lb));
+      int emax = static_cast<int>(log10(Ea_ub));
+      Real de = 0.1;
+      int num = 1+static_cast<int>((emax - emin) / de);
+
+      Eigen::Matrix<Real,Eigen::Dynamic,1> Eas(num),logAs(num);
+      std::vector<Real> ones(num,Real(1)), logOmegas(num);
+      for(int j = 0; j < num; ++j)
+        Eas[j] = pow(10,emin + de*j);
+
       // compute a set of (Ea,log(A)) pairs
+      {
+      LIBARRHENIUS_STATS_TIMER(Scan);
       for(size_t i = 0; i < N.size(); i++)
       {
-
-        // We'll calculate (Ea,log(A)) pairs for every half decade
-        int emin = static_cast<int>(log10(Ea_lb));
-        int emax = static_cast<int>(log10(Ea_ub));
-        Real de = 0.1;
-        int num = 1+static_cast<int>((emax - emin) / de);
-
-        Eigen::Matrix<Real,Eigen::Dynamic,1> Eas(num),logAs(num);
+        // log(Omega) doesn't underflow at large Ea, even in double.
+        integrator.logOmega(profiles[i], num, ones.data(), Eas.data(), logOmegas.data());
+        LIBARRHENIUS_STATS_INTEGRATIONS(N[i], num);
         for(int j = 0; j < num; ++j)
-        {
-          Eas[j] = pow(10,emin + de*j);
-          integrator.setEa(Eas[j]);
-          integrator.setA(1);
-          logAs[j] = -log( integrator(N[i], t[i], T[i]) );
-        }
+          logAs[j] = -logOmegas[j];
         auto linreg = RUC::LinearRegression(Eas,logAs);
         // linreg[0] is 'b',
         // linreg[1] is 'm' for the fit
         logteff[i] = -linreg[0];
         invTeff[i] = linreg[1]*Constants::MKS::R;
       }
+      }
 
       // now perform linear regression with effective parameters
       auto linreg = RUC::LinearRegression( invTeff, logteff );
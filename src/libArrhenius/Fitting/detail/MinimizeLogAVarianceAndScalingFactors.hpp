@@ -7,6 +7,9 @@
   * @date 06/28/17
   */
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <utility>
 
 
@@ -18,6 +21,7 @@ using boost::math::tools::bracket_and_solve_root;
 using boost::math::tools::eps_tolerance;
 
 #include "../../ThresholdCalculator.hpp"
+#include "../../Stats.hpp"
 
 
 namespace libArrhenius {
@@ -40,6 +44,7 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
     Return
     exec() const
     {
+      LIBARRHENIUS_STATS_TIMER(Fit);
       BOOST_LOG_TRIVIAL(trace) << "MinimizeLogAVarianceAndScalignFactors: Executing Fit";
       // find Ea that minimizes the variance in corresponding A values.
       // then find A that minimizes scaling factor error
@@ -47,40 +52,76 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
       Return ret;
       ArrheniusIntegral<Real> integrator;
       ThresholdCalculator<decltype(integrator)> calc;
-      std::vector<Real*> const &t = this->t;
-      std::vector<Real*> const &T = this->T;
       std::vector<size_t> const &N = this->N;
+      std::vector<PreparedProfile<Real>> const profiles = this->prepareProfiles();
 
         
 
       // search for Ea
       
-      // the cost function for choosing Ea
-      // calculates and returns the sum of squared deviations.
-      auto Ea_cost = [&](Real Ea){
-
-        // cost is equal to the sum of squared deviations (i.e. proportional to variance)
-        integrator.setEa( Ea );
-        integrator.setA(1);
-
-        std::vector<Real> logAs(N.size());
-        for(size_t i = 0; i < N.size(); ++i)
-          logAs[i] = -log( integrator(N[i], t[i], T[i]) );
-
+      // calculates the sum of squared deviations of a set of log(A) values
+      auto logA_devs = [&](std::vector<Real> const &logAs){
         // calculate the mean
         Real mean = 0;
-        for(size_t i = 0; i < N.size(); ++i)
+        for(size_t i = 0; i < logAs.size(); ++i)
           mean += logAs[i];
-        mean /= N.size();
+        mean /= logAs.size();
 
         // calculate the sum of squared deviations
         Real devs = 0;
-        for(size_t i = 0; i < N.size(); ++i)
+        for(size_t i = 0; i < logAs.size(); ++i)
           devs += (logAs[i] - mean)*(logAs[i] - mean);
 
        return devs;
       };
 
+      // the cost function for choosing Ea
+      // calculates and returns the sum of squared deviations of log(A) at Ea, using logAs
+      // as a buffer. the profiles are integrated in parallel if requested (each thread
+      // with its own integrator), and the deviations are summed serially, in profile
+      // order, so the cost (and the fit) does not depend on the number of threads.
+      auto cost = [&](Real Ea, std::vector<Real> &logAs, bool parallel){
+
+        // cost is equal to the sum of squared deviations (i.e. proportional to variance)
+        LIBARRHENIUS_STATS_ADD(CostEvaluations, 1);
+        #pragma omp parallel if(parallel)
+        {
+          // log(Omega) doesn't underflow at large Ea, even in double.
+          ArrheniusIntegral<Real> local_integrator(1,Ea);
+          #pragma omp for schedule(dynamic)
+          for(size_t i = 0; i < N.size(); ++i)
+          {
+            logAs[i] = -local_integrator.logOmega(profiles[i]);
+            LIBARRHENIUS_STATS_INTEGRATIONS(N[i], 1);
+          }
+        }
+
+        return logA_devs(logAs);
+      };
+
+      // brent calls this hundreds of times, so it uses a buffer that is only allocated once
+      // and integrates the profiles in parallel when they are large enough.
+      std::vector<Real> cost_logAs(N.size());
+      size_t total_samples = 0;
+      for(size_t i = 0; i < N.size(); ++i)
+        total_samples += N[i];
+      bool parallel_cost = N.size() > 1 && total_samples >= integrator.getParallelThreshold();
+      auto Ea_cost = [&](Real Ea){
+        return cost(Ea, cost_logAs, parallel_cost);
+      };
+
+      // returns the index of the smallest cost in [begin,end).
+      // the minimum is picked serially so that ties go to the same point for any number of threads.
+      auto min_index = [](std::vector<Real> const &costs, size_t begin, size_t end){
+        size_t i_of_min = begin;
+        for(size_t i = begin + 1; i < end; ++i)
+        {
+          if( costs[i] < costs[i_of_min] )
+            i_of_min = i;
+        }
+        return i_of_min;
+      };
+
       // We need to get a range for Ea before we can run the minimization
       // function. So, we'll do a quick scan for the minimum.
       // If the caller has specified a bound use it.
@@ -98,41 +139,33 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
         Ea_ub = this->maxEa.get();
       }
 
-      int prec;
-      boost::uintmax_t maxit;
+      int prec = std::numeric_limits<Real>::digits - 3;
 
       if(!this->minEa || !this->maxEa)
       {
       BOOST_LOG_TRIVIAL(trace) << "Searching for upper bound on Ea";
-      prec = std::numeric_limits<Real>::digits - 3;
 
       {
-        // If Ea is too large, then the Arrhenius integral will
-        // return zero. The point at which this happens depends on the
-        // data type being used. Basically, higher-precision types can
-        // evaluate the integral at larger Ea's before reaching zero.
-        // So, we know Ea can't be larger than the smallest value that
-        // gives zero for the integral. This gives us an initial upper bound on Ea.
+        // the integral vanishes for Ea larger than some value that depends on the profile and
+        // data type, so the smallest of these is an initial upper bound on Ea.
+        // the searches are independent, so they run in parallel.
         bool found_one = false;
+        {
+        LIBARRHENIUS_STATS_TIMER(UpperBoundSearch);
+        std::vector<std::exception_ptr> errors;
+        std::vector<Real> bounds = this->EaUpperBounds( profiles, errors );
         for( size_t i = 0; i < N.size(); i++ )
         {
-          eps_tolerance<Real> tol( prec );
-          maxit = 100;
-          Real guess = 1e2; // a place to start
-          Real factor = 2;  // multiplication factor to use when searching for upper bound
-          try {
-          auto Ea_ub_range = bracket_and_solve_root( [&](Real Ea){
-              integrator.setEa(Ea);
-              integrator.setA(1);
-              return integrator(N[i],t[i],T[i]);}, guess, factor, false, tol, maxit );
-
-              // use the smallest Ea for the upper bound.
-              if( !found_one || Ea_ub_range.first < Ea_ub )
-                Ea_ub = Ea_ub_range.first;
-              found_one = true;
-          } catch( ... ) {
+          if( errors[i] )
+          {
             BOOST_LOG_TRIVIAL(warning) <<"WARNING: Could not determine an upper bound on Ea from thermal profile number " << i << ". Skipping";
+            continue;
           }
+          // use the smallest Ea for the upper bound.
+          if( !found_one || bounds[i] < Ea_ub )
+            Ea_ub = bounds[i];
+          found_one = true;
+        }
         }
         if( !found_one )
         {
@@ -145,53 +178,132 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
         // Now do a quick scan for the minimum.
         // We'll calculate the cost at every half decade for Ea.
         BOOST_LOG_TRIVIAL(trace) << "Scanning for minimum (rough estimate)";
-
-        
-        
-        while( Ea_cost(Ea_ub) == 0 )
+        LIBARRHENIUS_STATS_TIMER(Scan);
+
+        // the costs computed during the scan, so that no point is integrated twice.
+        std::map<Real,Real> scanned;
+
+        // returns the costs at several Ea. the points that have not been computed yet are
+        // independent, so they are computed in parallel, each one integrating all of the
+        // profiles serially.
+        auto Ea_costs = [&](std::vector<Real> const &Eas){
+          std::vector<Real> costs(Eas.size());
+          std::vector<size_t> todo;
+          for(size_t i = 0; i < Eas.size(); ++i)
+          {
+            auto it = scanned.find(Eas[i]);
+            if( it != scanned.end() )
+              costs[i] = it->second;
+            else
+              todo.push_back(i);
+          }
+          int num_todo = static_cast<int>(todo.size());
+          bool parallel_scan = num_todo > 1 && num_todo*total_samples >= integrator.getParallelThreshold();
+          #pragma omp parallel if(parallel_scan)
+          {
+            std::vector<Real> logAs(N.size());
+            #pragma omp for schedule(dynamic)
+            for(int k = 0; k < num_todo; ++k)
+              costs[todo[k]] = cost(Eas[todo[k]], logAs, false);
+          }
+          for(int k = 0; k < num_todo; ++k)
+            scanned[Eas[todo[k]]] = costs[todo[k]];
+          return costs;
+        };
+
+        // the cost is zero when every log(A) is the same, which happens near the upper
+        // bound if the integrals saturate. back off until the profiles can be told apart.
+        Real lowest_Ea = this->minEa ? Real(this->minEa.get()) : Real(1);
+        while( (scanned[Ea_ub] = Ea_cost(Ea_ub)) == 0 )
+        {
           Ea_ub /= 2;
+          if( Ea_ub < lowest_Ea )
+          {
+            BOOST_LOG_TRIVIAL(fatal)<<"ERROR: The cost function is zero for every Ea, the thermal profiles cannot be distinguished.";
+            throw std::runtime_error( "ERROR: The cost function is zero for every Ea, the thermal profiles cannot be distinguished.");
+          }
+        }
 
         // scan Ea from 1 to Ea_ub on a log-scale
         Real min_lnEa, max_lnEa, d_lnEa;
         min_lnEa = 0;
         max_lnEa = log(Ea_ub);
+        bool ends_at_Ea_ub = true;
         // check if we have limits configured. if so,
         // we should use them if they are more restrictive.
         if( this->minEa && log(this->minEa.get()) > min_lnEa )
           min_lnEa = log(this->minEa.get());
         if( this->maxEa && log(this->maxEa.get()) < max_lnEa )
+        {
           max_lnEa = log(this->maxEa.get());
-        // discretize
-        int num  = static_cast<int>((max_lnEa - min_lnEa) / 0.5); // half log spacing
+          ends_at_Ea_ub = false;
+        }
+        if( !(max_lnEa > min_lnEa) )
+        {
+          BOOST_LOG_TRIVIAL(fatal)<<"ERROR: The minimum Ea is not below the upper bound on Ea for the thermal profiles (" << Ea_ub << ").";
+          throw std::runtime_error( "ERROR: The minimum Ea is not below the upper bound on Ea for the thermal profiles.");
+        }
+        // discretize. the grid always has both ends, even if the range is less than the spacing.
+        int num  = std::max( 2, static_cast<int>((max_lnEa - min_lnEa) / 0.5) ); // half log spacing
         d_lnEa = (max_lnEa - min_lnEa) / (num - 1);
-        int i_of_min = 0;
-        Real min_cost = Ea_cost(exp(min_lnEa));
-        for(int i = 1; i < num; ++i)
+        std::vector<Real> Eas(num);
+        for(int i = 0; i < num; ++i)
+          Eas[i] = exp(min_lnEa + i*d_lnEa);
+        // use the last point of the back off exactly, so that it is not computed again.
+        if( ends_at_Ea_ub )
+          Eas[num-1] = Ea_ub;
+
+        std::vector<Real> costs = Ea_costs(Eas);
+        size_t i_of_min = min_index(costs, 0, costs.size());
+
+        if( i_of_min > 0 && i_of_min < Eas.size() - 1 )
         {
-          Ea_ub = exp(min_lnEa + i*d_lnEa);
-          Real cost = Ea_cost(Ea_ub);
-          if( cost < min_cost )
+          // the minimum is bracketed by its neighbors. refine the bracket by halving the spacing
+          // around the minimum a few times. each step only has to compute the two new mid points,
+          // the ends and the center of the bracket are reused. the mid points are computed in
+          // parallel, which is faster than letting brent narrow the bracket one point at a time.
+          BOOST_LOG_TRIVIAL(trace) << "Refining the bracket around " << Eas[i_of_min];
+          for(int refinement = 0; refinement < 3; ++refinement)
           {
-            i_of_min = i;
-            min_cost = cost;
+            Real lo = Eas[i_of_min-1], mid = Eas[i_of_min], hi = Eas[i_of_min+1];
+            Eas = { lo, exp((log(lo) + log(mid))/2), mid, exp((log(mid) + log(hi))/2), hi };
+            costs = Ea_costs(Eas);
+            // the ends can't be lower than the center, so the new minimum is inside.
+            i_of_min = min_index(costs, 1, 4);
           }
+          // the grid is inside the limits, so the refined bracket is too.
+          Ea_lb = Eas[i_of_min-1];
+          Ea_ub = Eas[i_of_min+1];
         }
-        if(!this->minEa)
-        {
-        Ea_lb = exp(min_lnEa + (i_of_min-1)*d_lnEa);
-        }
-        if(!this->maxEa)
+        else
         {
-        Ea_ub = exp(min_lnEa + (i_of_min+1)*d_lnEa);
+          // the minimum is at one end of the grid, so the bracket extends one step past it,
+          // unless that would go past a limit.
+          if(!this->minEa)
+          {
+          Ea_lb = exp(min_lnEa + (static_cast<int>(i_of_min)-1)*d_lnEa);
+          }
+          if(!this->maxEa)
+          {
+          Ea_ub = exp(min_lnEa + (static_cast<int>(i_of_min)+1)*d_lnEa);
+          }
+          else
+          {
+          Ea_ub = Eas[num-1];
+          }
         }
         BOOST_LOG_TRIVIAL(trace) << "Minimum between " << Ea_lb << " and " << Ea_ub;
       }
       }
 
-      maxit = 1000;
       BOOST_LOG_TRIVIAL(trace) << "Searching for Ea with Cost minimization";
-      auto Ea_min = brent_find_minima( Ea_cost, Ea_lb, Ea_ub, prec );
+      {
+      LIBARRHENIUS_STATS_TIMER(EaMinimization);
+      boost::uintmax_t it = std::numeric_limits<boost::uintmax_t>::max(); // the default, we just want the count.
+      auto Ea_min = brent_find_minima( Ea_cost, Ea_lb, Ea_ub, prec, it );
+      LIBARRHENIUS_STATS_ADD(MinimizerIterations, it);
       ret.Ea = Ea_min.first;
+      }
 
       // search for A
 
@@ -200,12 +312,12 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
       auto A_cost = [&](Real A){
 
         // cost is equal to the sum of squared deviations (i.e. proportional to variance)
+        LIBARRHENIUS_STATS_ADD(CostEvaluations, 1);
         calc.setEa( ret.Ea.get() );
         calc.setA( A );
 
-        std::vector<Real> thresholds(N.size());
-        for(size_t i = 0; i < N.size(); ++i)
-          thresholds[i] = calc(N[i], t[i], T[i]);
+        // the profiles are solved in parallel
+        std::vector<Real> thresholds = calc(profiles);
 
         // calculate the sum of squared deviations
         Real devs = 0;
@@ -216,9 +328,14 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
       };
 
       // get the range to search for A
+      integrator.setEa( ret.Ea.get() );
+      integrator.setA(1);
       std::vector<Real> As(N.size());
       for(size_t i = 0; i < N.size(); ++i)
-        As[i] = 1/integrator(N[i], t[i], T[i]);
+      {
+        As[i] = 1/integrator(profiles[i]);
+        LIBARRHENIUS_STATS_INTEGRATIONS(N[i], 1);
+      }
       Real A_lb = *std::min_element(As.begin(), As.end());
       Real A_ub = *std::max_element(As.begin(), As.end());
 
@@ -232,10 +349,14 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
       }
 
 
-      maxit = 1000;
       BOOST_LOG_TRIVIAL(trace) << "Searching for A with Cost minimization between " << A_lb << " and " << A_ub;
-      auto A_min = brent_find_minima( A_cost, A_lb, A_ub, prec );
+      {
+      LIBARRHENIUS_STATS_TIMER(AMinimization);
+      boost::uintmax_t it = std::numeric_limits<boost::uintmax_t>::max();
+      auto A_min = brent_find_minima( A_cost, A_lb, A_ub, prec, it );
+      LIBARRHENIUS_STATS_ADD(MinimizerIterations, it);
       ret.A = A_min.first;
+      }
 
       // OR....
       // find zero for log of average threshold
@@ -250,7 +371,7 @@ class ArrheniusFit<Real,MinimizeLogAVarianceAndScalingFactors> : public Arrheniu
             //calc.setA(A);
             //Real sum = 0;
             //for( int i = 0; i < N.size(); ++i )
-              //sum += calc(N[i], t[i], T[i]);
+              //sum += calc(profiles[i]);
             //sum /= N.size();
 
             //return static_cast<Real>(log(sum));}, guess, factor, false, tol, maxit );
@@ -19,6 +19,7 @@ using boost::math::tools::bracket_and_solve_root;
 using boost::math::tools::eps_tolerance;
 
 #include "../../ThresholdCalculator.hpp"
+#include "../../Stats.hpp"
 
 
 namespace libArrhenius {
@@ -41,15 +42,15 @@ namespace libArrhenius {
         Return
           exec() const
           {
+            LIBARRHENIUS_STATS_TIMER(Fit);
             BOOST_LOG_TRIVIAL(trace) << "MinimizeScalignFactors: Executing Fit";
             // find Ea and A that minimizes scaling factor error
 
             Return ret;
             ArrheniusIntegral<Real> integrator;
             ThresholdCalculator<decltype(integrator)> calc;
-            std::vector<Real*> const &t = this->t;
-            std::vector<Real*> const &T = this->T;
             std::vector<size_t> const &N = this->N;
+            std::vector<PreparedProfile<Real>> const profiles = this->prepareProfiles();
 
 
             // We need to get a range for Ea and A before we can run the minimization
@@ -70,12 +71,12 @@ namespace libArrhenius {
             // the cost function calculates and returns the sum of squared deviations of the scaling factors from 1
             auto cost = [&](Real Ea, Real A){
               // cost is equal to the sum of squared deviations (i.e. proportional to variance)
+              LIBARRHENIUS_STATS_ADD(CostEvaluations, 1);
               calc.setEa( Ea );
               calc.setA( A );
 
-              std::vector<Real> thresholds(N.size());
-              for(size_t i = 0; i < N.size(); ++i)
-                thresholds[i] = calc(N[i], t[i], T[i]);
+              // the profiles are solved in parallel
+              std::vector<Real> thresholds = calc(profiles);
 
               // calculate the sum of squared deviations
               Real devs = 0;
@@ -8,16 +8,30 @@
   */
 
 #include <cmath>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "../Constants.hpp"
 #include "./ArrheniusIntegralBase.hpp"
+#include "../Profiles/PreparedProfile.hpp"
 #include "./detail/Utils.hpp"
+#include "./detail/VectorizedExp.hpp"
+#include "./detail/VectorizedExpint.hpp"
+#include "./detail/ScaledProfile.hpp"
+#include "./detail/MixedPrecision.hpp"
+#include "./detail/LogSumExp.hpp"
+#include "./detail/BlockExtrema.hpp"
 
 namespace libArrhenius {
 
 
 struct Trapezoid {};
 struct ExponentialIntegral {};
+struct MixedPrecision {};
+struct Adaptive {};
+struct Pruned {};
 
 /** @class ArrheniusIntegral
   * @brief 
@@ -32,6 +46,9 @@ class ArrheniusIntegral {};
 // won't work if the user tries to include them directly
 #include "./detail/ArrheniusIntegral/Trapezoid.hpp"
 #include "./detail/ArrheniusIntegral/ExponentialIntegral.hpp"
+#include "./detail/ArrheniusIntegral/MixedPrecision.hpp"
+#include "./detail/ArrheniusIntegral/Adaptive.hpp"
+#include "./detail/ArrheniusIntegral/Pruned.hpp"
 
 
 #endif // include protector
@@ -19,7 +19,7 @@ class ArrheniusIntegralBase
 {
   protected:
     Real A, Ea;
-    size_t parallel_threshold = 4096;
+    size_t parallel_threshold = 1024;
 
   public:
 
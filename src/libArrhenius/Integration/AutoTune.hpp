@@ -0,0 +1,353 @@
+#ifndef Integration_AutoTune_hpp
+#define Integration_AutoTune_hpp
+
+/** @file AutoTune.hpp
+  * @brief Calibrates the parallel threshold of the integrators on the running machine.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace libArrhenius {
+
+/** @class ParallelThresholdCache
+  * @brief A small on-disk table of calibrated parallel thresholds.
+  * @author C.D. Clark III
+  *
+  * Each line of the file holds a key and a threshold, separated by a space. If the
+  * filename is empty, nothing is read or written. The directory of the file is created
+  * when a threshold is stored. Errors reading or writing the file are ignored, the only
+  * consequence is that the calibration is run again.
+  */
+class ParallelThresholdCache
+{
+  protected:
+    std::string filename;
+
+  public:
+    ParallelThresholdCache( std::string filename_ = defaultFilename() )
+    :filename(std::move(filename_))
+    {}
+
+    /** Returns $LIBARRHENIUS_TUNING_CACHE if it is set, otherwise a file in $XDG_CACHE_HOME or $HOME/.cache. */
+    static std::string defaultFilename()
+    {
+      const char *env = std::getenv("LIBARRHENIUS_TUNING_CACHE");
+      if( env )
+        return env;
+      env = std::getenv("XDG_CACHE_HOME");
+      if( env && *env )
+        return std::string(env) + "/libArrhenius-parallel-thresholds.txt";
+      env = std::getenv("HOME");
+      if( env && *env )
+        return std::string(env) + "/.cache/libArrhenius-parallel-thresholds.txt";
+      return "";
+    }
+
+    std::string getFilename() const { return filename; }
+
+    /** Returns an identifier for the running machine: the hostname and the CPU model.
+      *
+      * Thresholds calibrated on one machine are not used on another one that shares the
+      * cache file (e.g. through a network home directory). The identifier does not contain
+      * white space, so it can be used in a key.
+      */
+    static std::string machineId()
+    {
+      std::string host = "unknown-host";
+#if defined(__unix__) || defined(__APPLE__)
+      char name[256] = {0};
+      if( gethostname( name, sizeof(name) - 1 ) == 0 && name[0] )
+        host = name;
+#else
+      const char *env = std::getenv("COMPUTERNAME");
+      if( env && *env )
+        host = env;
+#endif
+
+      // x86 reports the CPU in "model name", other architectures use one of the other fields.
+      std::string cpu = "unknown-cpu";
+      const char *fields[] = { "model name", "cpu model", "Processor", "uarch", "cpu\t" };
+      std::size_t best = sizeof(fields)/sizeof(fields[0]);
+      std::ifstream cpuinfo("/proc/cpuinfo");
+      std::string line;
+      while( best > 0 && std::getline(cpuinfo,line) )
+      {
+        for( std::size_t f = 0; f < best; ++f )
+        {
+          auto colon = line.find(':');
+          if( line.compare( 0, std::strlen(fields[f]), fields[f] ) != 0 || colon == std::string::npos )
+            continue;
+          auto value = line.find_first_not_of( " \t", colon + 1 );
+          if( value != std::string::npos )
+          {
+            cpu = line.substr( value );
+            best = f;
+          }
+          break;
+        }
+      }
+
+      std::string id = host + "/" + cpu;
+      for( auto &c : id )
+        if( std::isspace( static_cast<unsigned char>(c) ) )
+          c = '_';
+      return id;
+    }
+
+    /** Looks up the threshold for key. Returns false if it is not in the cache. */
+    bool lookup( std::string const &key, std::size_t &threshold ) const
+    {
+      for( auto const &entry : read() )
+      {
+        if( entry.first == key )
+        {
+          threshold = entry.second;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** Adds (or replaces) the threshold for key. */
+    void store( std::string const &key, std::size_t threshold ) const
+    {
+      if( filename.empty() )
+        return;
+      auto entries = read();
+      bool found = false;
+      for( auto &entry : entries )
+      {
+        if( entry.first == key )
+        {
+          entry.second = threshold;
+          found = true;
+        }
+      }
+      if( !found )
+        entries.emplace_back( key, threshold );
+
+      // the cache directory (e.g. ~/.cache) may not exist yet. if it can't be created,
+      // opening the file below fails.
+      boost::system::error_code ec;
+      boost::filesystem::path parent = boost::filesystem::path(filename).parent_path();
+      if( !parent.empty() )
+        boost::filesystem::create_directories( parent, ec );
+
+      // write to a temporary file and rename it so that a concurrent reader never sees a partial file.
+      // the name is unique so that processes storing at the same time don't write to the same file.
+      std::string tmp = filename + "." + boost::filesystem::unique_path().string() + ".tmp";
+      {
+        std::ofstream out(tmp.c_str());
+        if( !out )
+          return;
+        for( auto const &entry : entries )
+          out << entry.first << " " << entry.second << "\n";
+        out.close();
+        if( !out )
+        {
+          std::remove( tmp.c_str() );
+          return;
+        }
+      }
+      if( std::rename( tmp.c_str(), filename.c_str() ) != 0 )
+        std::remove( tmp.c_str() );
+    }
+
+  protected:
+    std::vector<std::pair<std::string,std::size_t>> read() const
+    {
+      std::vector<std::pair<std::string,std::size_t>> entries;
+      if( filename.empty() )
+        return entries;
+      std::ifstream in(filename.c_str());
+      std::string line;
+      while( std::getline(in,line) )
+      {
+        std::istringstream ss(line);
+        std::string key;
+        std::size_t threshold;
+        if( ss >> key >> threshold )
+          entries.emplace_back( key, threshold );
+      }
+      return entries;
+    }
+};
+
+/** @class ParallelThresholdTuner
+  * @brief Finds the profile size at which an integrator's parallel loop starts to pay off.
+  * @author C.D. Clark III
+  *
+  * The cost of a sample depends on the Real type and the method (a cpp_dec_float_100 sample
+  * costs about 100 times what a double sample does), so the crossover is calibrated for each
+  * integrator type, and for the number of threads available.
+  */
+// this allows the specialization below to detuce Real and Method types for integrators.
+template< class Integrator >
+class ParallelThresholdTuner {};
+
+template< template<typename,typename> class Integrator, typename Real, typename Method>
+class ParallelThresholdTuner<Integrator<Real,Method>>
+{
+  public:
+    /** The number of threads that a parallel loop will use. */
+    static int maxThreads()
+    {
+#ifdef _OPENMP
+      return omp_get_max_threads();
+#else
+      return 1;
+#endif
+    }
+
+    /** The cache key for this machine, integrator type and thread count. */
+    static std::string key()
+    {
+      return ParallelThresholdCache::machineId() + "/" + std::string( typeid(Integrator<Real,Method>).name() ) + "/" + std::to_string( maxThreads() );
+    }
+
+    /** Times the serial and parallel loops on synthetic profiles of increasing size.
+      *
+      * Returns the smallest size for which the parallel loop was faster, at that size and the next one.
+      * The search stops when a serial integration takes more than max_seconds, or the size passes max_N.
+      * If the parallel loop never wins, the largest size_t is returned, i.e. never parallelize.
+      */
+    static std::size_t calibrate( std::size_t max_N = 1 << 20, double max_seconds = 0.05 )
+    {
+      Integrator<Real,Method> integrator = make_integrator(0);
+      std::size_t candidate = 0;
+      for( std::size_t N = 512; N <= max_N; N *= 2 )
+      {
+        std::vector<Real> t(N), T(N);
+        for( std::size_t i = 0; i < N; ++i )
+        {
+          t[i] = 10.*i/N;
+          T[i] = 310 + 20*exp(-pow((t[i]-5)/2,2));
+        }
+
+        integrator.setParallelThreshold( N+1 );
+        double serial = time( integrator, N, t.data(), T.data() );
+        integrator.setParallelThreshold( 0 );
+        double parallel = time( integrator, N, t.data(), T.data() );
+
+        if( parallel < serial )
+        {
+          if( candidate )
+            return candidate;
+          candidate = N;
+        }
+        else
+        {
+          candidate = 0;
+        }
+
+        if( serial > max_seconds )
+          break;
+      }
+      return candidate ? candidate : std::numeric_limits<std::size_t>::max();
+    }
+
+    /** Returns the cached threshold, or calibrates it and adds it to the cache.
+      *
+      * With a single thread there is nothing to calibrate, and parallelization is disabled.
+      */
+    static std::size_t tuned( ParallelThresholdCache const &cache = ParallelThresholdCache() )
+    {
+      if( maxThreads() < 2 )
+        return std::numeric_limits<std::size_t>::max();
+
+      std::size_t threshold;
+      std::string k = key();
+      if( cache.lookup( k, threshold ) )
+        return threshold;
+
+      threshold = calibrate();
+      cache.store( k, threshold );
+      return threshold;
+    }
+
+  protected:
+    // best of a few runs.
+    static double time( Integrator<Real,Method> const &integrator, std::size_t N, Real const *t, Real const *T )
+    {
+      double best = std::numeric_limits<double>::infinity();
+      for( int r = 0; r < 3; ++r )
+      {
+        auto start = std::chrono::steady_clock::now();
+        integrator(N,t,T);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if( elapsed.count() < best )
+          best = elapsed.count();
+      }
+      return best;
+    }
+
+    // construct an integrator with typical coefficients. modified integrators take an exponent.
+    template<typename I = Integrator<Real,Method>>
+    static auto make_integrator(int) -> decltype( I( Real(1), Real(1), Real(0) ) )
+    {
+      return I( Real(3.1e99), Real(6.28e5), Real(0) );
+    }
+
+    template<typename I = Integrator<Real,Method>>
+    static I make_integrator(long)
+    {
+      return I( Real(3.1e99), Real(6.28e5) );
+    }
+};
+
+/** @class AutoTuned
+  * @brief An integrator whose parallel threshold is calibrated for the running machine.
+  * @author C.D. Clark III
+  *
+  * The threshold is looked up in the ParallelThresholdCache (or calibrated and cached)
+  * the first time an AutoTuned integrator of a given type is created in a process.
+  */
+// this allows the specialization below to detuce Real and Method types for integrators.
+template< class Integrator >
+class AutoTuned {};
+
+template< template<typename,typename> class Integrator, typename Real, typename Method>
+class AutoTuned<Integrator<Real,Method>> : public Integrator<Real,Method>
+  // by inheriting from the integrator, we can configure it directly through
+  // the tuned integrator without writing wrapper functions.
+{
+  public:
+    template<typename ...Args>
+    AutoTuned(Args&&... args)
+    :Integrator<Real,Method>(std::forward<Args>(args)...)
+    {
+      static const std::size_t threshold = ParallelThresholdTuner<Integrator<Real,Method>>::tuned();
+      this->setParallelThreshold( threshold );
+    }
+
+    virtual ~AutoTuned () {};
+
+  protected:
+};
+
+}
+
+#endif // include protector
@@ -0,0 +1,82 @@
+#ifndef Integration_BatchIntegrator_hpp
+#define Integration_BatchIntegrator_hpp
+
+/** @file BatchIntegrator.hpp
+  * @brief Integrates many thermal profiles in a single call.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <utility>
+#include <vector>
+
+#include "../Profiles/ProfileSet.hpp"
+#include "../Profiles/PreparedProfile.hpp"
+
+namespace libArrhenius {
+
+/** @class BatchIntegrator
+  * @brief Evaluates an integrator on every profile in a set, in parallel across profiles.
+  * @author C.D. Clark III
+  *
+  * The integrators only parallelize within a profile, which doesn't pay off for
+  * the short profiles typically found in a data set. This wrapper distributes
+  * whole profiles to threads instead.
+  */
+// this allows the specialization below to detuce Real and Method types for integrators.
+template< class Integrator >
+class BatchIntegrator {};
+
+template< template<typename,typename> class Integrator, typename Real, typename Method>
+class BatchIntegrator<Integrator<Real,Method>> : public Integrator<Real,Method>
+  // by inheriting from the integrator, we can configure it directly through
+  // the batch integrator without writing wrapper functions.
+{
+  public:
+    template<typename ...Args>
+    BatchIntegrator(Args&&... args)
+    :Integrator<Real,Method>(std::forward<Args>(args)...)
+    {
+    }
+
+    virtual ~BatchIntegrator () {};
+
+    // single profile integration is still available.
+    using Integrator<Real,Method>::operator();
+
+    /** Integrate M profiles stored back-to-back in t and T.
+      *
+      * Profile i occupies [offsets[i],offsets[i+1]) in t and T, so offsets must have M+1 entries.
+      * The results are written to Omega[0..M), in the same order as the profiles.
+      */
+    void operator()(std::size_t M, std::size_t const *offsets, Real const *t, Real const *T, Real *Omega) const
+    {
+      #pragma omp parallel for schedule(dynamic) if(M > 1)
+      for(std::size_t i = 0; i < M; ++i)
+        Omega[i] = Integrator<Real,Method>::operator()(offsets[i+1]-offsets[i], t+offsets[i], T+offsets[i]);
+    }
+
+    /** Integrate the profiles in a ProfileSet, or anything else that stores them the same way (i.e. a MappedProfileFile). */
+    template<typename Profiles>
+    auto operator()(Profiles const& profiles) const -> decltype( profiles.offsetData(), std::vector<Real>() )
+    {
+      std::vector<Real> Omega(profiles.size());
+      this->operator()(profiles.size(), profiles.offsetData(), profiles.tData(), profiles.TData(), Omega.data());
+      return Omega;
+    }
+
+    std::vector<Real> operator()(std::vector<PreparedProfile<Real>> const& profiles) const
+    {
+      std::vector<Real> Omega(profiles.size());
+      #pragma omp parallel for schedule(dynamic) if(profiles.size() > 1)
+      for(std::size_t i = 0; i < profiles.size(); ++i)
+        Omega[i] = Integrator<Real,Method>::operator()(profiles[i]);
+      return Omega;
+    }
+
+  protected:
+};
+
+}
+
+#endif // include protector
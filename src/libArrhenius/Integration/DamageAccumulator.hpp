@@ -0,0 +1,158 @@
+#ifndef Integration_DamageAccumulator_hpp
+#define Integration_DamageAccumulator_hpp
+
+/** @file DamageAccumulator.hpp
+  * @brief Integrates a thermal profile incrementally, as the samples arrive.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "../Constants.hpp"
+#include "./ArrheniusIntegral.hpp"
+#include "./ModifiedArrheniusIntegralBase.hpp"
+
+namespace libArrhenius {
+
+/** @class DamageAccumulator
+  * @brief Accumulates the damage integral for a thermal profile one sample (or one chunk) at a time.
+  * @author C.D. Clark III
+  *
+  * The integrators need the whole profile up front, so monitoring a profile as it is
+  * measured means re-integrating the entire history every time a sample arrives. The
+  * accumulator only keeps the last sample and the running sum, so each sample costs one
+  * exp(). It also records the time at which Omega first reached a threshold.
+  */
+template <typename Real, typename Method = Trapezoid >
+class DamageAccumulator {};
+
+template <typename Real>
+class DamageAccumulator<Real,Trapezoid> : public ModifiedArrheniusIntegralBase<Real>
+{
+  protected:
+    // this will keep up from having to use 'this->' to access these.
+    using ModifiedArrheniusIntegralBase<Real>::Ea;
+    using ModifiedArrheniusIntegralBase<Real>::A;
+    using ModifiedArrheniusIntegralBase<Real>::n;
+
+    Real ThresholdOmega = 1;
+
+    // the sum doesn't include the factor of A/2, same as the integrators.
+    Real sum = 0;
+    Real t_last = 0, f_last = 0;
+    std::size_t count = 0;
+    boost::optional<Real> threshold_time;
+
+  public:
+    DamageAccumulator( Real A_, Real Ea_, Real n_ = 0 )
+    {
+      this->setA(A_);
+      this->setEa(Ea_);
+      this->setExponent(n_);
+    }
+    DamageAccumulator( )
+    {
+      this->setExponent(0);
+    }
+    virtual ~DamageAccumulator () {};
+
+    void setThresholdOmega(Real O){ ThresholdOmega = O; }
+    Real getThresholdOmega() const {return ThresholdOmega;}
+
+    /** Forget all of the samples. The coefficients and threshold are kept.
+      *
+      * The coefficients must not be changed after samples have been added without calling reset().
+      */
+    void reset()
+    {
+      sum = 0;
+      t_last = 0;
+      f_last = 0;
+      count = 0;
+      threshold_time = boost::none;
+    }
+
+    /** Add the sample (t,T). Samples must be added in order of increasing time. */
+    void add( Real t, Real T )
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      Real f;
+      Integration::detail::exp_ratio( 1, alpha, &T, &f );
+      if( n != 0 )
+        f *= pow(T,n);
+      accumulate( t, f );
+    }
+
+    /** Add N samples. This is equivalent to adding them one at a time, but the exponentials are vectorized. */
+    void add( std::size_t N, Real const *t, Real const *T )
+    {
+      const std::size_t block = Integration::detail::block_size;
+      Real alpha = -Ea/Constants::MKS::R;
+      std::vector<Real> f( std::min( block, N ) );
+      for(std::size_t b = 0; b < N; b += block)
+      {
+        std::size_t m = std::min( block, N - b );
+        Integration::detail::exp_ratio( m, alpha, T + b, f.data() );
+        if( n != 0 )
+          for(std::size_t j = 0; j < m; ++j)
+            f[j] *= pow(T[b+j],n);
+        for(std::size_t j = 0; j < m; ++j)
+          accumulate( t[b+j], f[j] );
+      }
+    }
+
+    /** The damage accumulated so far. */
+    Real Omega() const { return 0.5*A*sum; }
+
+    /** The time at which Omega first reached the threshold, if it has.
+      *
+      * The rate is linear between samples (which is what the trapezoid rule assumes),
+      * so the time within the interval that crossed the threshold is found by solving
+      * a quadratic.
+      */
+    boost::optional<Real> thresholdTime() const { return threshold_time; }
+
+    /** The number of samples added so far. */
+    std::size_t size() const { return count; }
+
+  protected:
+    void accumulate( Real t, Real f )
+    {
+      if( count > 0 )
+      {
+        Real dt = t - t_last;
+        Real sum_last = sum;
+        sum += (f + f_last)*dt;
+        if( !threshold_time && 0.5*A*sum >= ThresholdOmega )
+          threshold_time = t_last + crossing( dt, sum_last, f );
+      }
+      t_last = t;
+      f_last = f;
+      ++count;
+    }
+
+    // the time after t_last at which the sum reached the threshold. the integral over the
+    // interval is f_last*s + (f - f_last)*s^2/(2 dt), so we need the root of a*s^2 + b*s + c.
+    Real crossing( Real dt, Real sum_last, Real f ) const
+    {
+      using std::sqrt;
+      Real a = (f - f_last)/(2*dt);
+      Real b = f_last;
+      Real c = (sum_last - 2*ThresholdOmega/A)/2;
+      if( !(c < 0) )
+        return 0;
+      // this form doesn't lose precision when a is small.
+      Real denom = b + sqrt( std::max( Real(b*b - 4*a*c), Real(0) ) );
+      if( !(denom > 0) )
+        return dt;
+      return std::min( Real(-2*c/denom), dt );
+    }
+};
+
+}
+
+#endif // include protector
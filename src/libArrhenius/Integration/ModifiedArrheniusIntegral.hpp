@@ -29,6 +29,7 @@ class ModifiedArrheniusIntegral {};
 // include specific implementations here as they
 // won't work if the user tries to include them directly
 #include "./detail/ModifiedArrheniusIntegral/Trapezoid.hpp"
+#include "./detail/ModifiedArrheniusIntegral/MixedPrecision.hpp"
 
 
 #endif // include protector
@@ -0,0 +1,257 @@
+#ifndef Integration_detail_ArrheniusIntegral_Adaptive_hpp
+#define Integration_detail_ArrheniusIntegral_Adaptive_hpp
+
+
+/** @file Adaptive.hpp
+  * @brief Contains ArrheniusIntegral class specialization for the adaptive method.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  *
+  * NOTE: This file is expected to be included from the ArrheniusIntegral.hpp
+  * It does not include any of the headers that are already included there, which
+  * only works if the contents of ArrheniusIntegral.hpp is included first.
+  */
+
+namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+/** @brief Returns the integral over [0,h1+h2] of the quadratic through (0,fa), (h1,fm) and (h1+h2,fb).
+  *
+  * This is Simpson's rule for unequal steps. If either step is empty, the trapezoid rule is used.
+  */
+template<typename Real>
+Real three_point_rule( Real h1, Real h2, Real fa, Real fm, Real fb )
+{
+  if( !(h1 > 0) || !(h2 > 0) )
+    return 0.5*(h1*(fa + fm) + h2*(fm + fb));
+  Real h = h1 + h2;
+  return h/6*( (2 - h2/h1)*fa + h*h/(h1*h2)*fm + (2 - h1/h2)*fb );
+}
+
+/** @brief A range of samples [lo,hi] in the adaptive integration. */
+template<typename Real>
+struct AdaptiveRange
+{
+  std::size_t lo, hi;
+  // the integrand at lo, (lo+hi)/2 and hi, and the three point rule on them.
+  Real f_lo, f_mid, f_hi, coarse;
+  // the integrand at the quarter points, and the three point rules on each half.
+  Real f_q1, f_q3, left, right;
+  // left + right, and an estimate of its error.
+  Real estimate, error;
+};
+
+/** @brief Returns the integral of exp(alpha/T(t)) over [t[0],t[N-1]], with T linear between the samples.
+  *
+  * The integral is computed with globally adaptive Simpson quadrature. The ranges of samples
+  * are bisected (by index, so the nodes are always samples) and the range with the largest
+  * error is split until the total error is below tolerance times the integral. A range
+  * with fewer than four intervals is integrated one interval at a time, which is treated
+  * as exact.
+  *
+  * The error of a range is the difference between its Simpson estimates with one and two
+  * panels, plus a bound on what the nodes can't see: the integrand increases with T, so the
+  * samples between the nodes can't add more than (f(max T) - max f(nodes))*(t[hi]-t[lo])
+  * (and similarly for the minimum). A narrow peak that falls between the nodes is therefore
+  * always found, and a range where T barely changes is accepted no matter how many samples
+  * it has.
+  */
+template<typename Real>
+Real adaptive_sum( std::size_t N, Real const *t, Real const *T, Real alpha, Real tolerance )
+{
+  using std::abs;
+  using std::exp;
+  if( N < 2 )
+    return 0;
+
+  auto f = [&]( Real T_ ){ return exp( alpha/T_ ); };
+
+  // integrates the intervals in [lo,hi] one at a time. Simpson's rule is accurate to about
+  // d^4/2880 if the exponent changes by d over the interval, larger changes (steep rises, or
+  // single sample spikes) use the exact integral, T*E2(-alpha/T)/(dT/dt) at the ends.
+  auto intervals = [&]( std::size_t lo, std::size_t hi ){
+    Real sum = 0;
+    Real f_last = f(T[lo]);
+    for(std::size_t i = lo + 1; i <= hi; ++i)
+    {
+      Real f_now = f(T[i]);
+      Real dt = t[i] - t[i-1];
+      if( abs( alpha/T[i] - alpha/T[i-1] ) < 0.05 )
+        sum += dt/6*( f_last + 4*f( (T[i] + T[i-1])/2 ) + f_now );
+      else
+        sum += ( T[i]*boost::math::expint( 2, -alpha/T[i] ) - T[i-1]*boost::math::expint( 2, -alpha/T[i-1] ) )*dt/(T[i] - T[i-1]);
+      f_last = f_now;
+    }
+    return sum;
+  };
+
+  if( N - 1 < 4 )
+    return intervals( 0, N - 1 );
+
+  BlockExtrema<Real> extrema( N, T );
+
+  // fills in the rest of a range that has its ends, mid point and coarse estimate set.
+  auto evaluate = [&]( AdaptiveRange<Real> &r ){
+    if( r.hi - r.lo < 4 )
+    {
+      r.estimate = intervals( r.lo, r.hi );
+      r.error = 0;
+      return;
+    }
+    std::size_t m = (r.lo + r.hi)/2, q1 = (r.lo + m)/2, q3 = (m + r.hi)/2;
+    r.f_q1 = f(T[q1]);
+    r.f_q3 = f(T[q3]);
+    r.left = three_point_rule<Real>( t[q1] - t[r.lo], t[m] - t[q1], r.f_lo, r.f_q1, r.f_mid );
+    r.right = three_point_rule<Real>( t[q3] - t[m], t[r.hi] - t[q3], r.f_mid, r.f_q3, r.f_hi );
+    r.estimate = r.left + r.right;
+    r.error = abs( r.estimate - r.coarse )/15;
+
+    std::size_t nodes[] = { r.lo, q1, m, q3, r.hi };
+    std::size_t i_max = r.lo, i_min = r.lo;
+    for( auto i : nodes )
+    {
+      if( T[i] > T[i_max] ) i_max = i;
+      if( T[i] < T[i_min] ) i_min = i;
+    }
+    auto range = extrema( r.lo, r.hi );
+    Real hidden = 0;
+    if( range.second > T[i_max] )
+      hidden += f(range.second) - f(T[i_max]);
+    if( range.first < T[i_min] )
+      hidden += f(T[i_min]) - f(range.first);
+    r.error += hidden*(t[r.hi] - t[r.lo]);
+  };
+
+  auto make = [&]( std::size_t lo, std::size_t hi, Real f_lo, Real f_mid, Real f_hi, Real coarse ){
+    AdaptiveRange<Real> r;
+    r.lo = lo;
+    r.hi = hi;
+    r.f_lo = f_lo;
+    r.f_mid = f_mid;
+    r.f_hi = f_hi;
+    r.coarse = coarse;
+    evaluate( r );
+    return r;
+  };
+
+  std::vector<AdaptiveRange<Real>> heap, done;
+  auto by_error = []( AdaptiveRange<Real> const &a, AdaptiveRange<Real> const &b ){ return a.error < b.error; };
+  auto add = [&]( AdaptiveRange<Real> const &r ){
+    // a range with no error is never split, and the error of a range that can't be split is zero.
+    if( r.error > 0 )
+    {
+      heap.push_back( r );
+      std::push_heap( heap.begin(), heap.end(), by_error );
+    }
+    else
+    {
+      done.push_back( r );
+    }
+  };
+
+  std::size_t mid = (N - 1)/2;
+  Real f_lo = f(T[0]), f_mid = f(T[mid]), f_hi = f(T[N-1]);
+  add( make( 0, N - 1, f_lo, f_mid, f_hi, three_point_rule<Real>( t[mid] - t[0], t[N-1] - t[mid], f_lo, f_mid, f_hi ) ) );
+  Real total = heap.empty() ? done[0].estimate : heap[0].estimate;
+  Real error = heap.empty() ? 0 : heap[0].error;
+
+  while( !heap.empty() )
+  {
+    if( error <= tolerance*total )
+    {
+      // the running totals drift, so check with fresh sums before stopping.
+      total = 0;
+      error = 0;
+      for( auto const &r : heap )
+      {
+        total += r.estimate;
+        error += r.error;
+      }
+      for( auto const &r : done )
+        total += r.estimate;
+      if( error <= tolerance*total )
+        break;
+    }
+
+    std::pop_heap( heap.begin(), heap.end(), by_error );
+    AdaptiveRange<Real> r = heap.back();
+    heap.pop_back();
+    total -= r.estimate;
+    error -= r.error;
+
+    std::size_t m = (r.lo + r.hi)/2;
+    AdaptiveRange<Real> halves[] = { make( r.lo, m, r.f_lo, r.f_q1, r.f_mid, r.left ),
+                                     make( m, r.hi, r.f_mid, r.f_q3, r.f_hi, r.right ) };
+    for( auto const &h : halves )
+    {
+      total += h.estimate;
+      error += h.error;
+      add( h );
+    }
+  }
+
+  // add the ranges up in order, so the result doesn't depend on the order they were split in.
+  done.insert( done.end(), heap.begin(), heap.end() );
+  std::sort( done.begin(), done.end(), []( AdaptiveRange<Real> const &a, AdaptiveRange<Real> const &b ){ return a.lo < b.lo; } );
+  Real sum = 0;
+  for( auto const &r : done )
+    sum += r.estimate;
+  return sum;
+}
+
+}
+}
+
+/** @class ArrheniusIntegral<Real,Adaptive>
+  * @brief Adaptive Simpson quadrature on the piecewise linear temperature profile.
+  *
+  * Intended for long, finely sampled profiles (e.g. FEM output) where most of the samples
+  * are on slowly varying or cold segments that contribute little to Omega. Those segments
+  * are covered by a few wide Simpson panels, while the peaks are refined down to the
+  * individual samples. The relative tolerance (1e-8 by default) bounds the quadrature
+  * error on top of the sampling of the profile, so the result agrees with the Trapezoid
+  * and ExponentialIntegral methods to within the O(dt^2) difference between them, not
+  * to round off. A tolerance of zero gives the integral of the linearly interpolated profile.
+  */
+template <typename Real>
+class ArrheniusIntegral<Real,Adaptive> : public ArrheniusIntegralBase<Real>
+{
+  protected:
+    // this will keep up from having to use 'this->' to access these.
+    using ArrheniusIntegralBase<Real>::Ea;
+    using ArrheniusIntegralBase<Real>::A;
+    Real tolerance = 1e-8;
+
+  public:
+    ArrheniusIntegral( Real A_, Real Ea_ )
+    {
+      this->setA(A_);
+      this->setEa(Ea_);
+    }
+    ArrheniusIntegral( )
+    {}
+    virtual ~ArrheniusIntegral () {};
+
+    /** Set the relative tolerance. Zero refines every range down to the individual samples. */
+    void setTolerance( Real tol ) { tolerance = tol; }
+    Real getTolerance( ) const { return tolerance; }
+
+
+    Real operator()( std::size_t N, Real const *t, Real const *T ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      return A*Integration::detail::adaptive_sum( N, t, T, alpha, tolerance );
+    }
+
+    Real operator()( PreparedProfile<Real> const &profile ) const
+    {
+      return this->operator()( profile.size(), profile.t(), profile.T() );
+    }
+
+};
+
+}
+
+
+#endif // include protector
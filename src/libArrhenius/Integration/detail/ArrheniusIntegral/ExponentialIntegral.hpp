@@ -6,7 +6,7 @@
 
 
 /** @file ExponentialIntegral.hpp
-  * @brief Contains ArrheniusIntegral class specialization for trapezoid method.
+  * @brief Contains ArrheniusIntegral class specialization for the exponential integral method.
   * @author C.D. Clark III
   * @date 06/26/17
   *
@@ -17,6 +17,127 @@
 
 namespace libArrhenius {
 
+namespace Integration {
+namespace detail {
+
+/** @brief Returns the integral of exp(-alpha/T) over the intervals [b,b+m), assuming T is linear in each interval.
+  *
+  * The exact integral over an interval is a difference of T*E2(alpha/T) at its ends. When the ends
+  * are too close for the difference to be accurate, the interval is integrated with a rectangle.
+  */
+template<typename Real>
+Real exponential_integral_block( std::size_t b, std::size_t m, Real const *t, Real const *T, Real alpha, Real tolerance )
+{
+  using std::abs;
+  Real sum = 0;
+  Real quadrature_last = T[b-1]*boost::math::expint(2,alpha/T[b-1] );
+  for(std::size_t i = b; i < b + m; ++i)
+  {
+    Real quadrature_now = T[i]*boost::math::expint(2,alpha/T[i] );
+    if( abs(1/T[i] - 1/T[i-1]) > tolerance )
+      sum += (quadrature_now - quadrature_last)*(t[i]-t[i-1])/(T[i] - T[i-1]);
+    else
+      sum += exp(-alpha/T[i])*(t[i] - t[i-1]);
+    quadrature_last = quadrature_now;
+  }
+  return sum;
+}
+
+/** @brief Vectorized exponential_integral_block for float and double.
+  *
+  * T*E2(alpha/T) and exp(-alpha/T) for the block are evaluated with the SIMD kernel first,
+  * then a second pass computes both the exact difference and the rectangle for every
+  * interval and picks one. A select whose sides divide is not vectorized, since the
+  * discarded division could raise a floating point exception that the scalar code
+  * doesn't, and the compiler turns a select of the denominator back into a branch.
+  * So the choice is made with a weight of exactly 0 or 1 (from copysign, not a
+  * comparison), and the intervals that use the rectangle divide by one instead of by
+  * their (possibly zero) temperature difference. The result is the same as the select.
+  */
+template<typename Real>
+Real vectorized_exponential_integral_block( std::size_t b, std::size_t m, Real const *t, Real const *T, Real alpha, Real tolerance )
+{
+  Real e[block_size+1], g[block_size+1];
+  expint2_ratio( m+1, alpha, T + b - 1, e, g );
+
+  Real sum = 0;
+  #pragma omp simd reduction(+:sum)
+  for(std::size_t j = 1; j <= m; ++j)
+  {
+    std::size_t i = b + j - 1;
+    Real dt = t[i] - t[i-1];
+    Real dT = T[i] - T[i-1];
+    // 1 if |1/T[i] - 1/T[i-1]| > tolerance (without the divisions), 0 otherwise.
+    Real exact = Real(0.5) - std::copysign( Real(0.5), tolerance*T[i]*T[i-1] - std::fabs(dT) );
+    Real difference = (T[i]*e[j]*g[j] - T[i-1]*e[j-1]*g[j-1])*dt;
+    Real rectangle = e[j]*dt;
+    sum += (exact*difference + (1 - exact)*rectangle)/(exact*dT + (1 - exact));
+  }
+  return sum;
+}
+
+inline double exponential_integral_block( std::size_t b, std::size_t m, double const *t, double const *T, double alpha, double tolerance )
+{
+  return vectorized_exponential_integral_block( b, m, t, T, alpha, tolerance );
+}
+
+inline float exponential_integral_block( std::size_t b, std::size_t m, float const *t, float const *T, float alpha, float tolerance )
+{
+  return vectorized_exponential_integral_block( b, m, t, T, alpha, tolerance );
+}
+
+/** @brief Same as exponential_integral_block, but uses precomputed time steps and inverse temperatures. */
+template<typename Real>
+Real prepared_exponential_integral_block( std::size_t b, std::size_t m, Real const *dt, Real const *T, Real const *invT, Real alpha, Real tolerance )
+{
+  using std::abs;
+  Real sum = 0;
+  Real quadrature_last = T[b-1]*boost::math::expint(2,alpha*invT[b-1] );
+  for(std::size_t i = b; i < b + m; ++i)
+  {
+    Real quadrature_now = T[i]*boost::math::expint(2,alpha*invT[i] );
+    if( abs(invT[i] - invT[i-1]) > tolerance )
+      sum += (quadrature_now - quadrature_last)*dt[i]/(T[i] - T[i-1]);
+    else
+      sum += exp(-alpha*invT[i])*dt[i];
+    quadrature_last = quadrature_now;
+  }
+  return sum;
+}
+
+/** @brief Vectorized prepared_exponential_integral_block for float and double, see vectorized_exponential_integral_block. */
+template<typename Real>
+Real vectorized_prepared_exponential_integral_block( std::size_t b, std::size_t m, Real const *dt, Real const *T, Real const *invT, Real alpha, Real tolerance )
+{
+  Real e[block_size+1], g[block_size+1];
+  expint2_product( m+1, alpha, invT + b - 1, e, g );
+
+  Real sum = 0;
+  #pragma omp simd reduction(+:sum)
+  for(std::size_t j = 1; j <= m; ++j)
+  {
+    std::size_t i = b + j - 1;
+    Real exact = Real(0.5) - std::copysign( Real(0.5), tolerance - std::fabs(invT[i] - invT[i-1]) );
+    Real difference = (T[i]*e[j]*g[j] - T[i-1]*e[j-1]*g[j-1])*dt[i];
+    Real rectangle = e[j]*dt[i];
+    sum += (exact*difference + (1 - exact)*rectangle)/(exact*(T[i] - T[i-1]) + (1 - exact));
+  }
+  return sum;
+}
+
+inline double prepared_exponential_integral_block( std::size_t b, std::size_t m, double const *dt, double const *T, double const *invT, double alpha, double tolerance )
+{
+  return vectorized_prepared_exponential_integral_block( b, m, dt, T, invT, alpha, tolerance );
+}
+
+inline float prepared_exponential_integral_block( std::size_t b, std::size_t m, float const *dt, float const *T, float const *invT, float alpha, float tolerance )
+{
+  return vectorized_prepared_exponential_integral_block( b, m, dt, T, invT, alpha, tolerance );
+}
+
+}
+}
+
 template <typename Real>
 class ArrheniusIntegral<Real,ExponentialIntegral> : public ArrheniusIntegralBase<Real>
 {
@@ -36,48 +157,28 @@ class ArrheniusIntegral<Real,ExponentialIntegral> : public ArrheniusIntegralBase
 
     Real operator()( std::size_t N, Real const *t, Real const *T ) const
     {
-      Real sum = 0;
       Real alpha = Ea/Constants::MKS::R;
       Real tolerance = 0.001/alpha;
-      // we need to have some way for each thread to tell if they have cached the first
-      // calculation or not.
-      Real quadrature_last;
-      bool have_last = false;
-
-#define LOOP \
-      for(size_t i = 1; i < N; ++i) \
-      { \
-        Real quadrature_now = T[i]*boost::math::expint(2,alpha/T[i] ); \
-        if(!have_last) \
-        { \
-          quadrature_last = quadrature_now; \
-          have_last = true; \
-          continue; \
-        } \
-        if( abs(1/T[i] - 1/T[i-1]) > tolerance ) \
-        { \
-          sum += (quadrature_now - quadrature_last)*(t[i]-t[i-1])/(T[i] - T[i-1]); \
-          quadrature_last = quadrature_now; \
-        } \
-        else \
-        { \
-          sum += exp(-alpha/T[i])*(t[i] - t[i-1]); \
-        } \
-      } \
-
-      if(N < parallel_threshold)
-      {
-        LOOP
-      }
-      else
-      {
-        // we have to use a special reduction function here
-        #pragma omp declare reduction( add:Real:omp_out=Integration::detail::add(omp_out, omp_in) )initializer(omp_priv=0)
-        #pragma omp parallel for schedule(static) reduction(add:sum) firstprivate(have_last) private(quadrature_last)
-        LOOP
-      }
+      // the profile is split into fixed size blocks that are summed in order,
+      // so the parallel result is identical to the serial one.
+      Real sum = Integration::detail::blocked_sum<Real>( N, N >= parallel_threshold,
+          [&](std::size_t b, std::size_t m){ return Integration::detail::exponential_integral_block( b, m, t, T, alpha, tolerance ); } );
+      sum *= A;
+      return sum;
+    }
+
+    /** Integrate a prepared profile.
+      *
+      * Prepared profiles are always integrated serially. Use a BatchIntegrator to
+      * integrate several of them in parallel.
+      */
+    Real operator()( PreparedProfile<Real> const &profile ) const
+    {
+      Real alpha = Ea/Constants::MKS::R;
+      Real tolerance = 0.001/alpha;
+      Real sum = Integration::detail::blocked_sum<Real>( profile.size(), false,
+          [&](std::size_t b, std::size_t m){ return Integration::detail::prepared_exponential_integral_block( b, m, profile.dt(), profile.T(), profile.invT(), alpha, tolerance ); } );
       sum *= A;
-#undef LOOP
       return sum;
     }
 
@@ -13,6 +13,116 @@
   */
 
 namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+/** @brief Returns the sum of (exp(alpha/T[i]) + exp(alpha/T[i-1]))*(t[i]-t[i-1]) for i in [b,b+m).
+  *
+  * This is one block of the trapezoid rule, without the factor of 1/2. The generic version
+  * caches the last exponential so that exp() is only called once per sample (plus once for
+  * the left boundary of the block).
+  */
+template<typename Real>
+Real trapezoid_block( std::size_t b, std::size_t m, Real const *t, Real const *T, Real alpha )
+{
+  Real sum = 0;
+  Real exp_last = exp( alpha/T[b-1] );
+  for(std::size_t i = b; i < b + m; ++i)
+  {
+    Real exp_now = exp( alpha/T[i] );
+    sum += (exp_now + exp_last)*(t[i]-t[i-1]);
+    exp_last = exp_now;
+  }
+  return sum;
+}
+
+/** @brief Vectorized trapezoid_block for float and double.
+  *
+  * The exponentials for the block are evaluated with the SIMD kernel first,
+  * and the trapezoid reduction is done in a second pass over the block,
+  * so neither loop has a dependency that would block vectorization.
+  */
+template<typename Real>
+Real vectorized_trapezoid_block( std::size_t b, std::size_t m, Real const *t, Real const *T, Real alpha )
+{
+  Real e[block_size+1];
+  exp_ratio( m+1, alpha, T + b - 1, e );
+
+  Real sum = 0;
+  #pragma omp simd reduction(+:sum)
+  for(std::size_t j = 1; j <= m; ++j)
+    sum += (e[j] + e[j-1])*(t[b+j-1]-t[b+j-2]);
+  return sum;
+}
+
+inline double trapezoid_block( std::size_t b, std::size_t m, double const *t, double const *T, double alpha )
+{
+  return vectorized_trapezoid_block( b, m, t, T, alpha );
+}
+
+inline float trapezoid_block( std::size_t b, std::size_t m, float const *t, float const *T, float alpha )
+{
+  return vectorized_trapezoid_block( b, m, t, T, alpha );
+}
+
+/** @brief Returns the sum of (exp(alpha/T[i]) + exp(alpha/T[i-1]))*(t[i]-t[i-1]) for i in [1,N).
+  *
+  * This is the trapezoid rule without the factor of 1/2. The result is the same
+  * (bit for bit) whether or not it is computed in parallel.
+  */
+template<typename Real>
+Real trapezoid_sum( std::size_t N, Real const *t, Real const *T, Real alpha, bool parallel = false )
+{
+  return blocked_sum<Real>( N, parallel, [&](std::size_t b, std::size_t m){ return trapezoid_block( b, m, t, T, alpha ); } );
+}
+
+/** @brief Same as trapezoid_block, but uses precomputed time steps and inverse temperatures. */
+template<typename Real>
+Real prepared_trapezoid_block( std::size_t b, std::size_t m, Real const *dt, Real const *invT, Real alpha )
+{
+  Real sum = 0;
+  Real exp_last = exp( alpha*invT[b-1] );
+  for(std::size_t i = b; i < b + m; ++i)
+  {
+    Real exp_now = exp( alpha*invT[i] );
+    sum += (exp_now + exp_last)*dt[i];
+    exp_last = exp_now;
+  }
+  return sum;
+}
+
+template<typename Real>
+Real vectorized_prepared_trapezoid_block( std::size_t b, std::size_t m, Real const *dt, Real const *invT, Real alpha )
+{
+  Real e[block_size+1];
+  exp_product( m+1, alpha, invT + b - 1, e );
+
+  Real sum = 0;
+  #pragma omp simd reduction(+:sum)
+  for(std::size_t j = 1; j <= m; ++j)
+    sum += (e[j] + e[j-1])*dt[b+j-1];
+  return sum;
+}
+
+inline double prepared_trapezoid_block( std::size_t b, std::size_t m, double const *dt, double const *invT, double alpha )
+{
+  return vectorized_prepared_trapezoid_block( b, m, dt, invT, alpha );
+}
+
+inline float prepared_trapezoid_block( std::size_t b, std::size_t m, float const *dt, float const *invT, float alpha )
+{
+  return vectorized_prepared_trapezoid_block( b, m, dt, invT, alpha );
+}
+
+/** @brief Same as trapezoid_sum, but uses precomputed time steps and inverse temperatures. */
+template<typename Real>
+Real prepared_trapezoid_sum( std::size_t N, Real const *dt, Real const *invT, Real alpha )
+{
+  return blocked_sum<Real>( N, false, [&](std::size_t b, std::size_t m){ return prepared_trapezoid_block( b, m, dt, invT, alpha ); } );
+}
+
+}
+}
 
 template <typename Real>
 class ArrheniusIntegral<Real,Trapezoid> : public ArrheniusIntegralBase<Real>
@@ -36,48 +146,181 @@ class ArrheniusIntegral<Real,Trapezoid> : public ArrheniusIntegralBase<Real>
 
     Real operator()( std::size_t N, Real const *t, Real const *T ) const
     {
-      Real sum = 0;
       Real alpha = -Ea/Constants::MKS::R;
-      // we need to have some way for each thread to tell if they have cached the first
-      // calculation or not.
-      Real exp_last;
-      bool have_last = false;
-
-      // see the celero benchmarks.
-      // using tmp variables and caching calls to exp() is *about*
-      // 3 times faster.
+      // see the integral benchmarks in testing/Benchmarks.
+      // the profile is split into fixed size blocks that are summed in order,
+      // so the parallel result is identical to the serial one.
       // parallelization can cost more than it saves on small for loops.
-#define LOOP \
-      for(size_t i = 1; i < N; ++i) \
-      { \
-        Real exp_now = exp( alpha/T[i] ); \
-        if(!have_last) \
-        { \
-          exp_last = exp_now; \
-          have_last = true; \
-          continue; \
-        } \
-        sum += (exp_now + exp_last)*(t[i]-t[i-1]); \
-        exp_last = exp_now; \
-      } \
-
-      if(N < parallel_threshold)
+      Real sum = Integration::detail::trapezoid_sum( N, t, T, alpha, N >= parallel_threshold );
+      sum *= 0.5*A;
+      return sum;
+    }
+
+    /** Integrate one profile for several sets of coefficients at once.
+      *
+      * Computes Omega[j] for the coefficients (As[j],Eas[j]), j in [0,M). This gives the same
+      * result as calling setA(As[j]), setEa(Eas[j]) and operator()(N,t,T) for each j, but
+      * 1/T and dt are only computed once, and the profile is only read once. The samples
+      * are processed in small blocks so that they stay in cache while every coefficient
+      * is applied.
+      */
+    void operator()( std::size_t N, Real const *t, Real const *T, std::size_t M, Real const *As, Real const *Eas, Real *Omegas ) const
+    {
+      const std::size_t block = Integration::detail::block_size;
+      std::vector<Real> alpha(M), sum(M,Real(0));
+      std::vector<Real> invT(block+1), dt(block), e(block+1);
+      for(std::size_t j = 0; j < M; ++j)
+        alpha[j] = -Eas[j]/Constants::MKS::R;
+
+      // same blocks as the single coefficient version.
+      for(std::size_t b = 1; b < N; b += block)
       {
-        LOOP
+        std::size_t n = std::min( block, N - b );
+        invT[0] = 1/T[b-1];
+        for(std::size_t i = 0; i < n; ++i)
+        {
+          invT[i+1] = 1/T[b+i];
+          dt[i] = t[b+i] - t[b+i-1];
+        }
+        accumulate_block( n, dt.data(), invT.data(), M, alpha.data(), e.data(), sum.data() );
       }
-      else
+
+      for(std::size_t j = 0; j < M; ++j)
+        Omegas[j] = 0.5*As[j]*sum[j];
+    }
+
+    /** Integrate a prepared profile for several sets of coefficients at once. */
+    void operator()( PreparedProfile<Real> const &profile, std::size_t M, Real const *As, Real const *Eas, Real *Omegas ) const
+    {
+      const std::size_t block = Integration::detail::block_size;
+      std::size_t N = profile.size();
+      std::vector<Real> alpha(M), sum(M,Real(0));
+      std::vector<Real> e(block+1);
+      for(std::size_t j = 0; j < M; ++j)
+        alpha[j] = -Eas[j]/Constants::MKS::R;
+
+      for(std::size_t b = 1; b < N; b += block)
+      {
+        std::size_t n = std::min( block, N - b );
+        accumulate_block( n, profile.dt()+b, profile.invT()+b-1, M, alpha.data(), e.data(), sum.data() );
+      }
+
+      for(std::size_t j = 0; j < M; ++j)
+        Omegas[j] = 0.5*As[j]*sum[j];
+    }
+
+    /** Integrate one profile for each (A,Ea) pair in coefficients. */
+    std::vector<Real> operator()( std::size_t N, Real const *t, Real const *T, std::vector<std::pair<Real,Real>> const &coefficients ) const
+    {
+      std::vector<Real> As(coefficients.size()), Eas(coefficients.size()), Omegas(coefficients.size());
+      for(std::size_t j = 0; j < coefficients.size(); ++j)
       {
-        // we have to use a special reduction function here
-        #pragma omp declare reduction( add:Real:omp_out=Integration::detail::add(omp_out, omp_in) )initializer(omp_priv=0)
-        #pragma omp parallel for schedule(static) reduction(add:sum) firstprivate(have_last) private(exp_last)
-        LOOP
+        As[j] = coefficients[j].first;
+        Eas[j] = coefficients[j].second;
       }
+      this->operator()( N, t, T, coefficients.size(), As.data(), Eas.data(), Omegas.data() );
+      return Omegas;
+    }
+
+    /** Integrate a prepared profile.
+      *
+      * Prepared profiles are always integrated serially. Use a BatchIntegrator to
+      * integrate several of them in parallel.
+      */
+    Real operator()( PreparedProfile<Real> const &profile ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      Real sum = Integration::detail::prepared_trapezoid_sum( profile.size(), profile.dt(), profile.invT(), alpha );
       sum *= 0.5*A;
-#undef LOOP
       return sum;
     }
 
+    /** Returns log(Omega).
+      *
+      * The sum is done in the log domain (log-sum-exp), so the result is accurate even when
+      * Omega itself would overflow or underflow Real. This lets the fits run in double, where
+      * exp(-Ea/RT) underflows for large activation energies. Always computed serially.
+      */
+    Real logOmega( std::size_t N, Real const *t, Real const *T ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      return log(0.5*A) + Integration::detail::log_trapezoid_sum( N, t, T, alpha, Real(0) );
+    }
+
+    Real logOmega( PreparedProfile<Real> const &profile ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      return log(0.5*A) + Integration::detail::prepared_log_trapezoid_sum( profile.size(), profile.dt(), profile.T(), profile.invT(), alpha, Real(0) );
+    }
+
+    /** Computes logOmegas[j] = log(Omega) for the coefficients (As[j],Eas[j]), j in [0,M).
+      *
+      * Like the multiple coefficient operator(), the profile is only read once. Each block of
+      * samples is added to a log domain sum for every coefficient while it is in cache.
+      */
+    void logOmega( PreparedProfile<Real> const &profile, std::size_t M, Real const *As, Real const *Eas, Real *logOmegas ) const
+    {
+      const std::size_t block = Integration::detail::block_size;
+      std::size_t N = profile.size();
+      Real const *T = profile.T();
+      std::vector<Real> alpha(M), u(block), e(block);
+      std::vector<Integration::detail::LogTrapezoidAccumulator<Real>> sums(M);
+      for(std::size_t j = 0; j < M; ++j)
+        alpha[j] = -Eas[j]/Constants::MKS::R;
+
+      for(std::size_t b = 0; b < N; b += block)
+      {
+        std::size_t n = std::min( block, N - b );
+        for(std::size_t i = 0; i < n; ++i)
+        {
+          if( !(T[b+i] > 0) )
+          {
+            std::fill( logOmegas, logOmegas + M, std::numeric_limits<Real>::quiet_NaN() );
+            return;
+          }
+        }
+        for(std::size_t j = 0; j < M; ++j)
+        {
+          for(std::size_t i = 0; i < n; ++i)
+            u[i] = alpha[j]*profile.invT()[b+i];
+          sums[j].add( n, u.data(), profile.dt() + b, e.data() );
+        }
+      }
+
+      for(std::size_t j = 0; j < M; ++j)
+        logOmegas[j] = log(0.5*As[j]) + sums[j].result();
+    }
+
+    /** Returns log(Omega) for the temperature profile T0 + x*dT[i], along with its first and second derivatives with respect to x.
+      *
+      * The scaled temperature profile is never stored. The ThresholdCalculator uses this
+      * to solve for thresholds with Halley's method.
+      */
+    std::tuple<Real,Real,Real> scaledLogOmega( std::size_t N, Real const *t, Real T0, Real x, Real const *dT ) const
+    {
+      auto r = Integration::detail::scaled_trapezoid_log_sum( N, t, T0, x, dT, static_cast<Real>(Ea/Constants::MKS::R), Real(0) );
+      std::get<0>(r) += log(0.5*A);
+      return r;
+    }
+
   protected:
+    // add the contribution of a block of n intervals to the running sums for M coefficients.
+    // invT points to the sample on the left boundary of the block (n+1 samples), and
+    // dt points to the first interval.
+    void accumulate_block( std::size_t n, Real const *dt, Real const *invT, std::size_t M, Real const *alpha, Real *e, Real *sum ) const
+    {
+      for(std::size_t j = 0; j < M; ++j)
+      {
+        Integration::detail::exp_product( n+1, alpha[j], invT, e );
+
+        Real block_sum = 0;
+        for(std::size_t i = 1; i <= n; ++i)
+          block_sum += (e[i] + e[i-1])*dt[i-1];
+
+        sum[j] += block_sum;
+      }
+    }
+
 };
 
 }
@@ -0,0 +1,83 @@
+#ifndef Integration_detail_BlockExtrema_hpp
+#define Integration_detail_BlockExtrema_hpp
+
+/** @file BlockExtrema.hpp
+  * @brief Minimum and maximum of a temperature profile over ranges of samples.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+/** @class BlockExtrema
+  * @brief A small index of the minimum and maximum of T over fixed size blocks of samples.
+  *
+  * Building the index reads the profile once and stores two values per block. A query
+  * for a range of samples scans the partial blocks at its ends and uses the index for
+  * the whole blocks in between. The profile is not copied, it has to outlive the index.
+  */
+template<typename Real>
+class BlockExtrema
+{
+  public:
+    static const std::size_t block = 64;
+
+  protected:
+    Real const *T;
+    std::vector<Real> mins, maxs;
+
+  public:
+    BlockExtrema( std::size_t N, Real const *T_ )
+    :T(T_), mins((N + block - 1)/block), maxs((N + block - 1)/block)
+    {
+      for(std::size_t k = 0; k < mins.size(); ++k)
+      {
+        std::size_t b = k*block, e = std::min( b + block, N );
+        auto range = std::minmax_element( T + b, T + e );
+        mins[k] = *range.first;
+        maxs[k] = *range.second;
+      }
+    }
+
+    /** Returns the minimum and maximum of T[lo], ..., T[hi] (inclusive). */
+    std::pair<Real,Real> operator()( std::size_t lo, std::size_t hi ) const
+    {
+      Real lower = T[lo], upper = T[lo];
+      auto scan = [&]( std::size_t b, std::size_t e ){
+        for(std::size_t i = b; i < e; ++i)
+        {
+          lower = std::min( lower, T[i] );
+          upper = std::max( upper, T[i] );
+        }
+      };
+
+      // the blocks that lie entirely inside of the range.
+      std::size_t bl = (lo + block - 1)/block, bh = (hi + 1)/block;
+      if( bl >= bh )
+      {
+        scan( lo, hi + 1 );
+        return std::make_pair( lower, upper );
+      }
+      scan( lo, bl*block );
+      for(std::size_t k = bl; k < bh; ++k)
+      {
+        lower = std::min( lower, mins[k] );
+        upper = std::max( upper, maxs[k] );
+      }
+      scan( bh*block, hi + 1 );
+      return std::make_pair( lower, upper );
+    }
+};
+
+}
+}
+}
+
+#endif // include protector
@@ -0,0 +1,273 @@
+#ifndef Integration_detail_LogSumExp_hpp
+#define Integration_detail_LogSumExp_hpp
+
+/** @file LogSumExp.hpp
+  * @brief Trapezoid sums computed in the log domain.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "./Utils.hpp"
+#include "./VectorizedExp.hpp"
+
+namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+/** @brief Returns log(S), where S is the sum of (exp(u(i)) + exp(u(i-1)))*dt(i) for i in [1,N).
+  *
+  * The exponents are shifted by their maximum before they are exponentiated (the log-sum-exp
+  * trick), so S can be far outside the range of Real without overflowing or underflowing.
+  * This is the generic version. It makes one pass over the samples to find the largest exponent,
+  * and a second to sum the shifted exponentials, which is cheaper than rescaling the sum every
+  * time the maximum changes.
+  *
+  * u(i) must return NaN for samples that are not valid (i.e. non-positive temperatures).
+  * If S is zero, -inf is returned.
+  */
+template<typename Real, typename Exponent, typename Step>
+Real log_trapezoid_sum_impl( std::size_t N, Exponent u, Step dt )
+{
+  using std::isnan;
+  Real u_max = -std::numeric_limits<Real>::infinity();
+  for(std::size_t i = 0; i < N; ++i)
+  {
+    Real ui = u(i);
+    if( isnan(ui) )
+      return ui;
+    if( ui > u_max )
+      u_max = ui;
+  }
+  if( N < 2 )
+    return -std::numeric_limits<Real>::infinity();
+
+  Real S = 0;
+  Real e_last = exp( u(0) - u_max );
+  for(std::size_t i = 1; i < N; ++i)
+  {
+    Real e = exp( u(i) - u_max );
+    S += (e + e_last)*dt(i);
+    e_last = e;
+  }
+  return static_cast<Real>( u_max + log(S) );
+}
+
+/** @brief Returns the largest of u[0], ..., u[m-1]. */
+template<typename Real>
+Real block_maximum( std::size_t m, Real const *u )
+{
+  Real u_max = u[0];
+  for(std::size_t j = 1; j < m; ++j)
+    if( u[j] > u_max )
+      u_max = u[j];
+  return u_max;
+}
+
+template<typename Real>
+Real vectorized_block_maximum( std::size_t m, Real const *u )
+{
+  Real u_max = u[0];
+  #pragma omp simd reduction(max:u_max)
+  for(std::size_t j = 1; j < m; ++j)
+    u_max = std::max( u_max, u[j] );
+  return u_max;
+}
+
+inline double block_maximum( std::size_t m, double const *u ) { return vectorized_block_maximum( m, u ); }
+inline float  block_maximum( std::size_t m, float  const *u ) { return vectorized_block_maximum( m, u ); }
+
+/** @brief Returns the sum of (e[j] + e[j-1])*dt[j] for j in [1,m). */
+template<typename Real>
+Real block_trapezoid( std::size_t m, Real const *e, Real const *dt )
+{
+  Real sum = 0;
+  for(std::size_t j = 1; j < m; ++j)
+    sum += (e[j] + e[j-1])*dt[j];
+  return sum;
+}
+
+template<typename Real>
+Real vectorized_block_trapezoid( std::size_t m, Real const *e, Real const *dt )
+{
+  Real sum = 0;
+  #pragma omp simd reduction(+:sum)
+  for(std::size_t j = 1; j < m; ++j)
+    sum += (e[j] + e[j-1])*dt[j];
+  return sum;
+}
+
+inline double block_trapezoid( std::size_t m, double const *e, double const *dt ) { return vectorized_block_trapezoid( m, e, dt ); }
+inline float  block_trapezoid( std::size_t m, float  const *e, float  const *dt ) { return vectorized_block_trapezoid( m, e, dt ); }
+
+/** @brief A log domain trapezoid sum that is built up one block of samples at a time.
+  *
+  * The sum is kept relative to the largest exponent seen so far, and is rescaled
+  * when a block contains a larger one, which only costs one exp() per block.
+  */
+template<typename Real>
+struct LogTrapezoidAccumulator
+{
+  Real u_max = -std::numeric_limits<Real>::infinity();
+  Real S = 0;
+  Real e_last = 0;
+  bool first = true;
+
+  /** Adds the next m samples. u holds their exponents (it is modified) and dt their time
+    * steps, dt[0] being the step from the last sample of the previous block (unused for
+    * the first block). e is scratch space for m values.
+    */
+  void add( std::size_t m, Real *u, Real const *dt, Real *e )
+  {
+    Real block_max = block_maximum( m, u );
+    if( block_max > u_max )
+    {
+      if( !first )
+      {
+        Real scale = exp( u_max - block_max );
+        S *= scale;
+        e_last *= scale;
+      }
+      u_max = block_max;
+    }
+
+    #pragma omp simd
+    for(std::size_t j = 0; j < m; ++j)
+      u[j] -= u_max;
+    exp_product( m, Real(1), u, e );
+
+    Real block_sum = block_trapezoid( m, e, dt );
+    if( !first )
+      block_sum += (e[0] + e_last)*dt[0];
+
+    S += block_sum;
+    e_last = e[m-1];
+    first = false;
+  }
+
+  /** Returns log(S), -inf if the sum is zero. */
+  Real result() const { return static_cast<Real>( u_max + log(S) ); }
+};
+
+/** @brief Vectorized log_trapezoid_sum_impl for float and double.
+  *
+  * fill(b,m,u,dt) writes the exponents and time steps for samples [b,b+m) to u[0..m) and dt[0..m)
+  * (the time step for sample 0 is not used), and returns false if any of the samples are not valid. The samples are processed in blocks,
+  * in a single pass, with a LogTrapezoidAccumulator.
+  */
+template<typename Real, typename Fill>
+Real vectorized_log_trapezoid_sum_impl( std::size_t N, Fill fill )
+{
+  const std::size_t block = block_size;
+  Real u[block], dt[block], e[block];
+  LogTrapezoidAccumulator<Real> sum;
+  for(std::size_t b = 0; b < N; b += block)
+  {
+    std::size_t m = std::min( block, N - b );
+    if( !fill( b, m, u, dt ) )
+      return std::numeric_limits<Real>::quiet_NaN();
+    sum.add( m, u, dt, e );
+  }
+  return sum.result();
+}
+
+/** @brief Returns log(trapezoid_sum), with f(T) = T^n exp(alpha/T).
+  *
+  * This uses the same samples as trapezoid_sum. If a temperature is not positive, NaN is returned. If the sum is zero, -inf is returned.
+  */
+template<typename Real>
+Real log_trapezoid_sum( std::size_t N, Real const *t, Real const *T, Real alpha, Real n )
+{
+  return log_trapezoid_sum_impl<Real>( N,
+      [&](std::size_t i){
+        if( !(T[i] > 0) )
+          return static_cast<Real>( std::numeric_limits<Real>::quiet_NaN() );
+        Real u = alpha/T[i];
+        if( n != 0 )
+          u += n*log(T[i]);
+        return u; },
+      [&](std::size_t i){ return static_cast<Real>(t[i] - t[i-1]); } );
+}
+
+template<typename Real>
+Real vectorized_log_trapezoid_sum( std::size_t N, Real const *t, Real const *T, Real alpha, Real n )
+{
+  return vectorized_log_trapezoid_sum_impl<Real>( N,
+      [&](std::size_t b, std::size_t m, Real *u, Real *dt){
+        bool ok = true;
+        #pragma omp simd reduction(&&:ok)
+        for(std::size_t j = 0; j < m; ++j)
+        {
+          ok = ok && T[b+j] > 0;
+          u[j] = alpha/T[b+j];
+        }
+        for(std::size_t j = (b == 0); j < m; ++j)
+          dt[j] = t[b+j] - t[b+j-1];
+        if( n != 0 )
+          for(std::size_t j = 0; j < m; ++j)
+            u[j] += n*std::log(T[b+j]);
+        return ok; } );
+}
+
+inline double log_trapezoid_sum( std::size_t N, double const *t, double const *T, double alpha, double n )
+{
+  return vectorized_log_trapezoid_sum( N, t, T, alpha, n );
+}
+
+inline float log_trapezoid_sum( std::size_t N, float const *t, float const *T, float alpha, float n )
+{
+  return vectorized_log_trapezoid_sum( N, t, T, alpha, n );
+}
+
+/** @brief Same as log_trapezoid_sum, but uses precomputed time steps and inverse temperatures. */
+template<typename Real>
+Real prepared_log_trapezoid_sum( std::size_t N, Real const *dt, Real const *T, Real const *invT, Real alpha, Real n )
+{
+  return log_trapezoid_sum_impl<Real>( N,
+      [&](std::size_t i){
+        if( !(T[i] > 0) )
+          return static_cast<Real>( std::numeric_limits<Real>::quiet_NaN() );
+        Real u = alpha*invT[i];
+        if( n != 0 )
+          u += n*log(T[i]);
+        return u; },
+      [&](std::size_t i){ return dt[i]; } );
+}
+
+template<typename Real>
+Real vectorized_prepared_log_trapezoid_sum( std::size_t N, Real const *dt, Real const *T, Real const *invT, Real alpha, Real n )
+{
+  return vectorized_log_trapezoid_sum_impl<Real>( N,
+      [&](std::size_t b, std::size_t m, Real *u, Real *dtb){
+        bool ok = true;
+        #pragma omp simd reduction(&&:ok)
+        for(std::size_t j = 0; j < m; ++j)
+        {
+          ok = ok && T[b+j] > 0;
+          u[j] = alpha*invT[b+j];
+          dtb[j] = dt[b+j];
+        }
+        if( n != 0 )
+          for(std::size_t j = 0; j < m; ++j)
+            u[j] += n*std::log(T[b+j]);
+        return ok; } );
+}
+
+inline double prepared_log_trapezoid_sum( std::size_t N, double const *dt, double const *T, double const *invT, double alpha, double n )
+{
+  return vectorized_prepared_log_trapezoid_sum( N, dt, T, invT, alpha, n );
+}
+
+inline float prepared_log_trapezoid_sum( std::size_t N, float const *dt, float const *T, float const *invT, float alpha, float n )
+{
+  return vectorized_prepared_log_trapezoid_sum( N, dt, T, invT, alpha, n );
+}
+
+}
+}
+}
+
+#endif // include protector
@@ -0,0 +1,146 @@
+#ifndef Integration_detail_MixedPrecision_hpp
+#define Integration_detail_MixedPrecision_hpp
+
+/** @file MixedPrecision.hpp
+  * @brief Trapezoid rule that evaluates exponentials in double and accumulates in long double.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "./Utils.hpp"
+#include "./VectorizedExp.hpp"
+
+namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+/** @brief The loop shared by the mixed precision sums.
+  *
+  * exponent(i,u) sets u to the exponent of sample i, computed in long double, and returns false if
+  * the temperature isn't positive. step(i) returns t[i]-t[i-1] in long double.
+  */
+template<typename Real, typename Exponent, typename Step>
+bool mixed_precision_sum( std::size_t N, Exponent const &exponent, Step const &step, Real &sum )
+{
+  typedef long double Work;
+  // exp(-40) is below double's epsilon, so terms with smaller (shifted) exponents don't matter.
+  const Work negligible = 40;
+  // an exponent u is computed with an error of about |u|*eps(Work). we need that to be below eps(double).
+  const Work max_exponent = std::numeric_limits<double>::epsilon()/std::numeric_limits<Work>::epsilon()/2;
+
+  if( N < 2 )
+  {
+    sum = 0;
+    return true;
+  }
+
+  Work u[block_size+1];
+  double d[block_size+1], e[block_size+1];
+  Work shift = -std::numeric_limits<Work>::infinity();
+  Work S = 0, c = 0;
+  // same blocks as blocked_sum, each block evaluates the sample on its left boundary too.
+  for(std::size_t b = 1; b < N; b += block_size)
+  {
+    std::size_t m = std::min( block_size, N - b );
+    Work u_max = shift;
+    for(std::size_t j = 0; j <= m; ++j)
+    {
+      if( !exponent( b-1+j, u[j] ) )
+        return false;
+      u_max = std::max( u_max, u[j] );
+    }
+    if( u_max > shift )
+    {
+      // exp(-inf) is zero, and so is the sum before the first block.
+      Work scale = std::exp( shift - u_max );
+      S *= scale;
+      c *= scale;
+      shift = u_max;
+    }
+
+    for(std::size_t j = 0; j <= m; ++j)
+      d[j] = static_cast<double>( u[j] - shift );
+    exp_product( m+1, 1.0, d, e );
+
+    for(std::size_t j = 1; j <= m; ++j)
+    {
+      // Kahan summation
+      Work y = (static_cast<Work>(e[j]) + static_cast<Work>(e[j-1]))*step( b+j-1 ) - c;
+      Work s = S + y;
+      c = (s - S) - y;
+      S = s;
+    }
+  }
+
+  if( !(std::abs(shift) + negligible < max_exponent) )
+    return false;
+
+  sum = static_cast<Real>(S)*static_cast<Real>( exp( static_cast<Real>(shift) ) );
+  return true;
+}
+
+/** @brief Computes the sum of (f(T[i]) + f(T[i-1]))*(t[i]-t[i-1]), with f(T) = T^n exp(alpha/T), in mixed precision.
+  *
+  * This is the same sum as trapezoid_sum, but Real is only used for the time steps and the final scaling. The exponents
+  * are computed in long double and shifted by the largest one seen so far, so the exponentials can be
+  * evaluated in double (with the SIMD kernel) without overflowing or underflowing. The
+  * shifted sum is accumulated in long double with Kahan summation (and rescaled when the
+  * shift increases), and then scaled by exp(shift) in Real. The profile is processed in the
+  * same blocks as trapezoid_sum, with the exponents of a block kept on the stack.
+  *
+  * The shift removes the dynamic range problem, but the exponents themselves are only as
+  * accurate as long double allows. If the largest exponent is too large to be computed to
+  * double precision, or a temperature isn't positive, false is returned and sum is not
+  * set. The caller should fall back to Real.
+  */
+template<typename Real>
+bool mixed_precision_trapezoid_sum( std::size_t N, Real const *t, Real const *T, Real const &alpha, Real const &n, Real &sum )
+{
+  typedef long double Work;
+  Work a = static_cast<Work>(alpha);
+  Work nn = static_cast<Work>(n);
+  return mixed_precision_sum( N,
+      [&](std::size_t i, Work &u){
+        Work TT = static_cast<Work>(T[i]);
+        if( !(TT > 0) )
+          return false;
+        u = a/TT;
+        if( nn != 0 )
+          u += nn*std::log(TT);
+        return true;
+      },
+      // take the difference in Real so that we don't lose digits when t is large compared to dt.
+      [&](std::size_t i){ return static_cast<Work>( Real(t[i] - t[i-1]) ); },
+      sum );
+}
+
+/** @brief Same as mixed_precision_trapezoid_sum, using the time steps and inverse temperatures of a PreparedProfile. */
+template<typename Real>
+bool mixed_precision_prepared_trapezoid_sum( std::size_t N, Real const *dt, Real const *T, Real const *invT, Real const &alpha, Real const &n, Real &sum )
+{
+  typedef long double Work;
+  Work a = static_cast<Work>(alpha);
+  Work nn = static_cast<Work>(n);
+  return mixed_precision_sum( N,
+      [&](std::size_t i, Work &u){
+        Work TT = static_cast<Work>(T[i]);
+        if( !(TT > 0) )
+          return false;
+        u = a*static_cast<Work>(invT[i]);
+        if( nn != 0 )
+          u += nn*std::log(TT);
+        return true;
+      },
+      [&](std::size_t i){ return static_cast<Work>(dt[i]); },
+      sum );
+}
+
+}
+}
+}
+
+#endif // include protector
@@ -0,0 +1,81 @@
+#ifndef Integration_detail_ModifiedArrheniusIntegral_MixedPrecision_hpp
+#define Integration_detail_ModifiedArrheniusIntegral_MixedPrecision_hpp
+
+
+/** @file MixedPrecision.hpp
+  * @brief Contains ModifiedArrheniusIntegral class specialization for the mixed precision trapezoid method.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  *
+  * NOTE: This file is expected to be included from the ModifiedArrheniusIntegral.hpp
+  * It does not include any of the headers that are already included there, which
+  * only works if the contents of ModifiedArrheniusIntegral.hpp is included first.
+  */
+
+namespace libArrhenius {
+
+/** @class ModifiedArrheniusIntegral<Real,MixedPrecision>
+  * @brief Trapezoid rule that only uses Real where it is needed.
+  *
+  * Intended for multiprecision Real types. The exponentials are evaluated in double
+  * and summed in long double, which gives the same result as the Trapezoid method to
+  * about double precision, at close to double speed. If the exponents are too large
+  * for that (large Ea/RT), the Trapezoid method is used with Real.
+  */
+template <typename Real>
+class ModifiedArrheniusIntegral<Real,MixedPrecision> : public ModifiedArrheniusIntegralBase<Real>
+{
+  protected:
+    // this will keep up from having to use 'this->' to access these.
+    using ModifiedArrheniusIntegralBase<Real>::Ea;
+    using ModifiedArrheniusIntegralBase<Real>::A;
+    using ModifiedArrheniusIntegralBase<Real>::n;
+
+  public:
+    ModifiedArrheniusIntegral( Real A_, Real Ea_, Real n_ )
+    {
+      this->setA(A_);
+      this->setEa(Ea_);
+      this->setExponent(n_);
+    }
+    ModifiedArrheniusIntegral( )
+    {}
+    virtual ~ModifiedArrheniusIntegral () {};
+
+
+    Real operator()( std::size_t N, Real const *t, Real const *T ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      Real sum;
+      if( Integration::detail::mixed_precision_trapezoid_sum( N, t, T, alpha, n, sum ) )
+        return 0.5*A*sum;
+
+      // double can't handle this one.
+      return fallback()( N, t, T );
+    }
+
+    Real operator()( PreparedProfile<Real> const &profile ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      Real sum;
+      if( Integration::detail::mixed_precision_prepared_trapezoid_sum( profile.size(), profile.dt(), profile.T(), profile.invT(), alpha, n, sum ) )
+        return 0.5*A*sum;
+
+      return fallback()( profile );
+    }
+
+  protected:
+    // the full precision integrator, with the same configuration as this one.
+    ModifiedArrheniusIntegral<Real,Trapezoid> fallback() const
+    {
+      ModifiedArrheniusIntegral<Real,Trapezoid> integrator( A, Ea, n );
+      integrator.setParallelThreshold( this->getParallelThreshold() );
+      return integrator;
+    }
+
+};
+
+}
+
+
+#endif // include protector
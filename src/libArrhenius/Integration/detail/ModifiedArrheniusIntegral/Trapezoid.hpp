@@ -14,6 +14,42 @@
 
 namespace libArrhenius {
 
+namespace Integration {
+namespace detail {
+
+/** @brief Returns the sum of (f(T[i]) + f(T[i-1]))*(t[i]-t[i-1]) for i in [b,b+m), with f(T) = T^n exp(alpha/T). */
+template<typename Real>
+Real modified_trapezoid_block( std::size_t b, std::size_t m, Real const *t, Real const *T, Real alpha, Real n )
+{
+  Real sum = 0;
+  Real exp_last = pow(T[b-1],n)*exp( alpha/T[b-1] );
+  for(std::size_t i = b; i < b + m; ++i)
+  {
+    Real exp_now = pow(T[i],n)*exp( alpha/T[i] );
+    sum += (exp_now + exp_last)*(t[i]-t[i-1]);
+    exp_last = exp_now;
+  }
+  return sum;
+}
+
+/** @brief Same as modified_trapezoid_block, but uses precomputed time steps and inverse temperatures. */
+template<typename Real>
+Real prepared_modified_trapezoid_block( std::size_t b, std::size_t m, Real const *dt, Real const *T, Real const *invT, Real alpha, Real n )
+{
+  Real sum = 0;
+  Real exp_last = pow(T[b-1],n)*exp( alpha*invT[b-1] );
+  for(std::size_t i = b; i < b + m; ++i)
+  {
+    Real exp_now = pow(T[i],n)*exp( alpha*invT[i] );
+    sum += (exp_now + exp_last)*dt[i];
+    exp_last = exp_now;
+  }
+  return sum;
+}
+
+}
+}
+
 template <typename Real>
 class ModifiedArrheniusIntegral<Real,Trapezoid> : public ModifiedArrheniusIntegralBase<Real>
 {
@@ -38,47 +74,56 @@ class ModifiedArrheniusIntegral<Real,Trapezoid> : public ModifiedArrheniusIntegr
 
     Real operator()( std::size_t N, Real const *t, Real const *T ) const
     {
-      Real sum = 0;
       Real alpha = -Ea/Constants::MKS::R;
-      // we need to have some way for each thread to tell if they have cached the first
-      // calculation or not.
-      Real exp_last;
-      bool have_last = false;
-
-      // see the celero benchmarks.
-      // using tmp variables and caching calls to exp() is *about*
-      // 3 times faster.
+      // see the integral benchmarks in testing/Benchmarks.
+      // the profile is split into fixed size blocks that are summed in order,
+      // so the parallel result is identical to the serial one.
       // parallelization can cost more than it saves on small for loops.
-#define LOOP \
-      for(size_t i = 1; i < N; ++i) \
-      { \
-        Real exp_now = pow(T[i],n)*exp( alpha/T[i] ); \
-        if(!have_last) \
-        { \
-          exp_last = exp_now; \
-          have_last = true; \
-          continue; \
-        } \
-        sum += (exp_now + exp_last)*(t[i]-t[i-1]); \
-        exp_last = exp_now; \
-      } \
-
-      if(N < parallel_threshold)
-      {
-        LOOP
-      }
-      else
-      {
-        // we have to use a special reduction function here
-        #pragma omp declare reduction( add:Real:omp_out=Integration::detail::add(omp_out, omp_in) )initializer(omp_priv=0)
-        #pragma omp parallel for schedule(static) reduction(add:sum) firstprivate(have_last) private(exp_last)
-        LOOP
-      }
+      Real sum = Integration::detail::blocked_sum<Real>( N, N >= parallel_threshold,
+          [&](std::size_t b, std::size_t m){ return Integration::detail::modified_trapezoid_block( b, m, t, T, alpha, n ); } );
       sum *= 0.5*A;
-#undef LOOP
       return sum;
     }
 
+    /** Integrate a prepared profile.
+      *
+      * Prepared profiles are always integrated serially. Use a BatchIntegrator to
+      * integrate several of them in parallel.
+      */
+    Real operator()( PreparedProfile<Real> const &profile ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      Real sum = Integration::detail::blocked_sum<Real>( profile.size(), false,
+          [&](std::size_t b, std::size_t m){ return Integration::detail::prepared_modified_trapezoid_block( b, m, profile.dt(), profile.T(), profile.invT(), alpha, n ); } );
+      sum *= 0.5*A;
+      return sum;
+    }
+
+    /** Returns log(Omega), computed in the log domain. See ArrheniusIntegral<Real,Trapezoid>::logOmega. */
+    Real logOmega( std::size_t N, Real const *t, Real const *T ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      return log(0.5*A) + Integration::detail::log_trapezoid_sum( N, t, T, alpha, n );
+    }
+
+    Real logOmega( PreparedProfile<Real> const &profile ) const
+    {
+      Real alpha = -Ea/Constants::MKS::R;
+      return log(0.5*A) + Integration::detail::prepared_log_trapezoid_sum( profile.size(), profile.dt(), profile.T(), profile.invT(), alpha, n );
+    }
+
+    /** Returns log(Omega) for the temperature profile T0 + x*dT[i], along with its first and second derivatives with respect to x.
+      *
+      * The scaled temperature profile is never stored. The ThresholdCalculator uses this
+      * to solve for thresholds with Halley's method.
+      */
+    std::tuple<Real,Real,Real> scaledLogOmega( std::size_t N, Real const *t, Real T0, Real x, Real const *dT ) const
+    {
+      auto r = Integration::detail::scaled_trapezoid_log_sum( N, t, T0, x, dT, static_cast<Real>(Ea/Constants::MKS::R), n );
+      std::get<0>(r) += log(0.5*A);
+      return r;
+    }
+
   protected:
 };
 
@@ -0,0 +1,226 @@
+#ifndef Integration_detail_ScaledProfile_hpp
+#define Integration_detail_ScaledProfile_hpp
+
+/** @file ScaledProfile.hpp
+  * @brief Trapezoid sums over a scaled temperature profile, with derivatives.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include "./Utils.hpp"
+#include "./VectorizedExp.hpp"
+
+namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+/** @brief Returns log(S) and its first two derivatives with respect to x. S is the sum of
+  * (f(T[i]) + f(T[i-1]))*(t[i]-t[i-1]), with T[i] = T0 + x*dT[i] and f(T) = T^n exp(-c/T).
+  *
+  * This uses the same samples as trapezoid_sum, but the temperature profile is computed
+  * as it is needed rather than stored. The exponents are
+  * shifted by their maximum before they are exponentiated, so the sums can't overflow or
+  * underflow, even when S itself would.
+  *
+  * If a temperature is not positive, log(S) is NaN. If S is zero, log(S) is -inf and the
+  * derivatives are NaN.
+  */
+template<typename Real>
+std::tuple<Real,Real,Real> scaled_trapezoid_log_sum( std::size_t N, Real const *t, Real T0, Real x, Real const *dT, Real c, Real n )
+{
+  // computes the exponent u = log(f(T[i])) and its first two derivatives.
+  auto exponent = [&](std::size_t i, Real &u, Real &du, Real &d2u)
+  {
+    Real invT = 1/(T0 + x*dT[i]);
+    Real r = dT[i]*invT;
+    u = -c*invT;
+    du = (c*invT + n)*r;
+    d2u = -(2*c*invT + n)*r*r;
+    if( n != 0 )
+      u -= n*log(invT);
+  };
+
+  Real u, du, d2u;
+
+  // check that all temperatures are positive, and find the largest exponent.
+  // if n = 0, the largest exponent is at the largest temperature.
+  Real T_max = 0;
+  for(std::size_t i = 0; i < N; ++i)
+  {
+    Real T = T0 + x*dT[i];
+    if( !(T > 0) )
+      return std::make_tuple( std::numeric_limits<Real>::quiet_NaN(), std::numeric_limits<Real>::quiet_NaN(), std::numeric_limits<Real>::quiet_NaN() );
+    if( T > T_max )
+      T_max = T;
+  }
+  Real u_max = -c/T_max;
+  if( n != 0 )
+  {
+    u_max = -std::numeric_limits<Real>::infinity();
+    for(std::size_t i = 0; i < N; ++i)
+    {
+      exponent(i,u,du,d2u);
+      if( u > u_max )
+        u_max = u;
+    }
+  }
+
+  // S0 is the (shifted) sum, S1 and S2 are its first and second derivatives.
+  Real S0 = 0, S1 = 0, S2 = 0;
+  Real e_last = 0, g_last = 0, h_last = 0;
+  for(std::size_t i = 0; i < N; ++i)
+  {
+    exponent(i,u,du,d2u);
+    Real e = exp( u - u_max );
+    Real g = e*du;
+    Real h = e*(du*du + d2u);
+    if( i > 0 )
+    {
+      Real dt = t[i] - t[i-1];
+      S0 += (e + e_last)*dt;
+      S1 += (g + g_last)*dt;
+      S2 += (h + h_last)*dt;
+    }
+    e_last = e;
+    g_last = g;
+    h_last = h;
+  }
+
+  if( S0 == 0 )
+    return std::make_tuple( -std::numeric_limits<Real>::infinity(), std::numeric_limits<Real>::quiet_NaN(), std::numeric_limits<Real>::quiet_NaN() );
+
+  Real d1 = S1/S0;
+  Real d2 = S2/S0 - d1*d1;
+  return std::make_tuple( static_cast<Real>(u_max + log(S0)), d1, d2 );
+}
+
+/** @brief Vectorized scaled_trapezoid_log_sum for float and double.
+  *
+  * The profile is processed in blocks. The exponents for a block are computed first, then
+  * exponentiated with the SIMD kernel, and the sums are accumulated in a last pass.
+  */
+template<typename Real>
+std::tuple<Real,Real,Real> vectorized_scaled_trapezoid_log_sum( std::size_t N, Real const *t, Real T0, Real x, Real const *dT, Real c, Real n )
+{
+  const std::size_t block = block_size;
+  Real TT[block], u[block], e[block];
+  const Real nan = std::numeric_limits<Real>::quiet_NaN();
+  const Real inf = std::numeric_limits<Real>::infinity();
+
+  // computes the inverse temperatures and exponents for a block.
+  Real *invT = TT;
+  auto fill = [&](std::size_t b, std::size_t m)
+  {
+    #pragma omp simd
+    for(std::size_t j = 0; j < m; ++j)
+    {
+      invT[j] = 1/(T0 + x*dT[b+j]);
+      u[j] = -c*invT[j];
+    }
+    if( n != 0 )
+      for(std::size_t j = 0; j < m; ++j)
+        u[j] -= n*log(invT[j]);
+  };
+
+  // the temperatures are extreme where dT is, so we can check that they are all
+  // positive without dividing.
+  Real dT_min = inf, dT_max = -inf;
+  #pragma omp simd reduction(min:dT_min) reduction(max:dT_max)
+  for(std::size_t i = 0; i < N; ++i)
+  {
+    dT_min = std::min( dT_min, dT[i] );
+    dT_max = std::max( dT_max, dT[i] );
+  }
+  Real T_min = std::min( T0 + x*dT_min, T0 + x*dT_max );
+  Real T_max = std::max( T0 + x*dT_min, T0 + x*dT_max );
+  if( N > 0 && !(T_min > 0) )
+    return std::make_tuple( nan, nan, nan );
+
+  // find the largest exponent. if n = 0 it is at the largest temperature.
+  Real u_max = -c/T_max;
+  if( n != 0 )
+  {
+    u_max = -inf;
+    for(std::size_t b = 0; b < N; b += block)
+    {
+      std::size_t m = std::min( block, N - b );
+      fill(b,m);
+      for(std::size_t j = 0; j < m; ++j)
+        u_max = std::max( u_max, u[j] );
+    }
+  }
+
+  // S0 is the (shifted) sum, S1 and S2 are its first and second derivatives.
+  Real S0 = 0, S1 = 0, S2 = 0;
+  Real e_last = 0, g_last = 0, h_last = 0;
+  for(std::size_t b = 0; b < N; b += block)
+  {
+    std::size_t m = std::min( block, N - b );
+    fill(b,m);
+    for(std::size_t j = 0; j < m; ++j)
+      u[j] -= u_max;
+    exp_product( m, Real(1), u, e );
+
+    // overwrite u and invT with e*du and e*(du*du + d2u).
+    Real *g = u, *h = invT;
+    #pragma omp simd
+    for(std::size_t j = 0; j < m; ++j)
+    {
+      Real r = dT[b+j]*invT[j];
+      Real du = (c*invT[j] + n)*r;
+      Real d2u = -(2*c*invT[j] + n)*r*r;
+      g[j] = e[j]*du;
+      h[j] = e[j]*(du*du + d2u);
+    }
+
+    Real s0 = 0, s1 = 0, s2 = 0;
+    if( b > 0 )
+    {
+      Real dt = t[b] - t[b-1];
+      s0 += (e[0] + e_last)*dt;
+      s1 += (g[0] + g_last)*dt;
+      s2 += (h[0] + h_last)*dt;
+    }
+    #pragma omp simd reduction(+:s0,s1,s2)
+    for(std::size_t j = 1; j < m; ++j)
+    {
+      Real dt = t[b+j] - t[b+j-1];
+      s0 += (e[j] + e[j-1])*dt;
+      s1 += (g[j] + g[j-1])*dt;
+      s2 += (h[j] + h[j-1])*dt;
+    }
+    S0 += s0;
+    S1 += s1;
+    S2 += s2;
+    e_last = e[m-1];
+    g_last = g[m-1];
+    h_last = h[m-1];
+  }
+
+  if( S0 == 0 )
+    return std::make_tuple( -inf, nan, nan );
+
+  Real d1 = S1/S0;
+  Real d2 = S2/S0 - d1*d1;
+  return std::make_tuple( static_cast<Real>(u_max + log(S0)), d1, d2 );
+}
+
+inline std::tuple<double,double,double> scaled_trapezoid_log_sum( std::size_t N, double const *t, double T0, double x, double const *dT, double c, double n )
+{
+  return vectorized_scaled_trapezoid_log_sum( N, t, T0, x, dT, c, n );
+}
+
+inline std::tuple<float,float,float> scaled_trapezoid_log_sum( std::size_t N, float const *t, float T0, float x, float const *dT, float c, float n )
+{
+  return vectorized_scaled_trapezoid_log_sum( N, t, T0, x, dT, c, n );
+}
+
+}
+}
+}
+
+#endif // include protector
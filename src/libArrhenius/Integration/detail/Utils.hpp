@@ -7,15 +7,43 @@
   * @date 07/08/17
   */
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 namespace libArrhenius {
 namespace Integration {
 namespace detail {
-// we need an add function that can be used to reduce user-defined types with
-// openmp
-template<typename Real>
-Real add(Real r, Real n)
+// number of intervals in a block for blocked_sum.
+const std::size_t block_size = 256;
+
+/** @brief Returns the sum of f(b,m) over the blocks of intervals [b,b+m) that cover [1,N).
+  *
+  * Interval i lies between samples i-1 and i. The blocks all have block_size intervals
+  * (except the last), and the block sums are always added in the same order, so the result
+  * is bitwise identical whether the blocks are evaluated serially or in parallel, and for
+  * any number of threads. f can't carry state from one block to the next, so it has
+  * to evaluate the sample on the left boundary of its block itself.
+  */
+template<typename Real, typename F>
+Real blocked_sum( std::size_t N, bool parallel, F f )
 {
-  return r+n;
+  std::size_t num_blocks = N > 1 ? (N - 2)/block_size + 1 : 0;
+  Real sum = 0;
+  if( !parallel || num_blocks < 2 )
+  {
+    for(std::size_t k = 0; k < num_blocks; ++k)
+      sum += f( 1 + k*block_size, std::min( block_size, N - 1 - k*block_size ) );
+    return sum;
+  }
+
+  std::vector<Real> partial(num_blocks);
+  #pragma omp parallel for schedule(static)
+  for(std::size_t k = 0; k < num_blocks; ++k)
+    partial[k] = f( 1 + k*block_size, std::min( block_size, N - 1 - k*block_size ) );
+  for(std::size_t k = 0; k < num_blocks; ++k)
+    sum += partial[k];
+  return sum;
 }
 
 }
@@ -0,0 +1,245 @@
+#ifndef Integration_detail_VectorizedExp_hpp
+#define Integration_detail_VectorizedExp_hpp
+
+/** @file VectorizedExp.hpp
+  * @brief Branch-free exp() for float and double that the compiler can vectorize.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  *
+  * std::exp is an opaque library call, so a loop that calls it once per sample
+  * can't be vectorized. The functions here evaluate exp with a Cody-Waite range
+  * reduction and a polynomial, using only arithmetic, compares and integer bit
+  * operations, so a `#pragma omp simd` loop over them turns into AVX2/AVX-512/NEON
+  * code. On x86 the kernels are compiled for several instruction sets and the
+  * best one supported by the running CPU is selected the first time it is called.
+  */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__)
+#define LIBARRHENIUS_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define LIBARRHENIUS_ALWAYS_INLINE inline
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBARRHENIUS_X86_DISPATCH
+#endif
+
+namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+template<typename Real>
+struct VectorizedExp {};
+
+template<>
+struct VectorizedExp<double>
+{
+  /** @brief exp(x) accurate to a couple of ulp over the whole double range. */
+  static LIBARRHENIUS_ALWAYS_INLINE double eval( double x )
+  {
+    const double log2e  = 1.4426950408889634074;
+    const double ln2_hi = 6.93147180369123816490e-01;
+    const double ln2_lo = 1.90821492927058770002e-10;
+    // adding this to a number with |n| < 2^51 rounds it to an integer and leaves
+    // that integer in the low bits of the mantissa.
+    const double shifter = 6755399441055744.0; // 0x1.8p52
+
+    // 2^k can't be built directly near the ends of the exponent range (subnormal
+    // results, or k = 1024 just below overflow), so build 2^(k+-512) there instead
+    // and apply the remaining factor at the end.
+    bool small = x < -708.0;
+    bool large = x >  708.0;
+    double xs = x < -745.2 ? -745.2 : x;
+    xs = xs > 709.8 ? 709.8 : xs;
+
+    double kd = xs*log2e + shifter;
+    double k  = kd - shifter;
+    double r  = xs - k*ln2_hi - k*ln2_lo;
+
+    // exp(r) for |r| <= ln(2)/2, degree 13 Taylor polynomial.
+    double p = 1.0/6227020800.0;
+    p = p*r + 1.0/479001600.0;
+    p = p*r + 1.0/39916800.0;
+    p = p*r + 1.0/3628800.0;
+    p = p*r + 1.0/362880.0;
+    p = p*r + 1.0/40320.0;
+    p = p*r + 1.0/5040.0;
+    p = p*r + 1.0/720.0;
+    p = p*r + 1.0/120.0;
+    p = p*r + 1.0/24.0;
+    p = p*r + 1.0/6.0;
+    p = p*r + 0.5;
+    p = p*r + 1.0;
+    p = p*r + 1.0;
+
+    // 2^k
+    std::uint64_t bits;
+    std::memcpy( &bits, &kd, sizeof(bits) );
+    bits = small ? bits + 512 : bits;
+    bits = large ? bits - 512 : bits;
+    bits = (bits << 52) + (std::uint64_t(1023) << 52);
+    double scale;
+    std::memcpy( &scale, &bits, sizeof(scale) );
+
+    double y = p*scale;
+    y = small ? y*7.4583407312002067433e-155 : y; // 2^-512
+    y = large ? y*1.3407807929942597100e+154 : y; // 2^512
+    y = x < -745.2 ? 0.0 : y;
+    y = x >  709.8 ? std::numeric_limits<double>::infinity() : y;
+    y = x != x ? x : y;
+    return y;
+  }
+};
+
+template<>
+struct VectorizedExp<float>
+{
+  /** @brief exp(x) accurate to a couple of ulp over the whole float range. */
+  static LIBARRHENIUS_ALWAYS_INLINE float eval( float x )
+  {
+    const float log2e  = 1.44269504f;
+    const float ln2_hi = 6.93145752e-1f;
+    const float ln2_lo = 1.42860677e-6f;
+    const float shifter = 12582912.0f; // 0x1.8p23
+
+    bool small = x < -87.0f;
+    bool large = x >  87.0f;
+    float xs = x < -104.0f ? -104.0f : x;
+    xs = xs > 88.8f ? 88.8f : xs;
+
+    float kf = xs*log2e + shifter;
+    float k  = kf - shifter;
+    float r  = xs - k*ln2_hi - k*ln2_lo;
+
+    // exp(r) for |r| <= ln(2)/2, degree 7 Taylor polynomial.
+    float p = 1.0f/5040.0f;
+    p = p*r + 1.0f/720.0f;
+    p = p*r + 1.0f/120.0f;
+    p = p*r + 1.0f/24.0f;
+    p = p*r + 1.0f/6.0f;
+    p = p*r + 0.5f;
+    p = p*r + 1.0f;
+    p = p*r + 1.0f;
+
+    std::uint32_t bits;
+    std::memcpy( &bits, &kf, sizeof(bits) );
+    bits = small ? bits + 64 : bits;
+    bits = large ? bits - 64 : bits;
+    bits = (bits << 23) + (std::uint32_t(127) << 23);
+    float scale;
+    std::memcpy( &scale, &bits, sizeof(scale) );
+
+    float y = p*scale;
+    y = small ? y*5.42101086e-20f : y; // 2^-64
+    y = large ? y*1.84467441e+19f : y; // 2^64
+    y = x < -104.0f ? 0.0f : y;
+    y = x >  88.8f  ? std::numeric_limits<float>::infinity() : y;
+    y = x != x ? x : y;
+    return y;
+  }
+};
+
+
+// the argument of the exponential is either alpha/x or alpha*x (when 1/T has
+// already been computed).
+struct Ratio   { template<typename Real> static LIBARRHENIUS_ALWAYS_INLINE Real apply( Real alpha, Real x ) { return alpha/x; } };
+struct Product { template<typename Real> static LIBARRHENIUS_ALWAYS_INLINE Real apply( Real alpha, Real x ) { return alpha*x; } };
+
+/** @brief Computes out[i] = exp(Op::apply(alpha,x[i])) for i in [0,n).
+  *
+  * This is the portable kernel. Use exp_ratio() or exp_product(), which pick the widest
+  * instruction set the CPU supports.
+  */
+template<typename Op, typename Real>
+LIBARRHENIUS_ALWAYS_INLINE void exp_kernel_generic( std::size_t n, Real alpha, Real const *x, Real *out )
+{
+  #pragma omp simd
+  for(std::size_t i = 0; i < n; ++i)
+    out[i] = VectorizedExp<Real>::eval( Op::apply( alpha, x[i] ) );
+}
+
+#ifdef LIBARRHENIUS_X86_DISPATCH
+template<typename Op, typename Real>
+__attribute__((target("avx2,fma")))
+void exp_kernel_avx2( std::size_t n, Real alpha, Real const *x, Real *out )
+{
+  exp_kernel_generic<Op>( n, alpha, x, out );
+}
+
+template<typename Op, typename Real>
+__attribute__((target("avx512f")))
+void exp_kernel_avx512( std::size_t n, Real alpha, Real const *x, Real *out )
+{
+  exp_kernel_generic<Op>( n, alpha, x, out );
+}
+#endif
+
+template<typename Op, typename Real>
+void exp_kernel_default( std::size_t n, Real alpha, Real const *x, Real *out )
+{
+  exp_kernel_generic<Op>( n, alpha, x, out );
+}
+
+template<typename Op, typename Real>
+struct ExpKernel
+{
+  typedef void (*type)( std::size_t, Real, Real const*, Real* );
+
+  static type select()
+  {
+#ifdef LIBARRHENIUS_X86_DISPATCH
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx512f") )
+      return &exp_kernel_avx512<Op,Real>;
+    if( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") )
+      return &exp_kernel_avx2<Op,Real>;
+#endif
+    return &exp_kernel_default<Op,Real>;
+  }
+
+  static void exec( std::size_t n, Real alpha, Real const *x, Real *out )
+  {
+    static const type kernel = select();
+    kernel( n, alpha, x, out );
+  }
+};
+
+/** @brief Computes out[i] = exp(alpha/T[i]) for i in [0,n).
+  *
+  * float and double use the runtime-selected SIMD kernel, other types call exp().
+  */
+template<typename Real>
+void exp_ratio( std::size_t n, Real alpha, Real const *T, Real *out )
+{
+  using std::exp;
+  for(std::size_t i = 0; i < n; ++i)
+    out[i] = exp( alpha/T[i] );
+}
+inline void exp_ratio( std::size_t n, double alpha, double const *T, double *out ) { ExpKernel<Ratio,double>::exec( n, alpha, T, out ); }
+inline void exp_ratio( std::size_t n, float  alpha, float  const *T, float  *out ) { ExpKernel<Ratio,float >::exec( n, alpha, T, out ); }
+
+/** @brief Computes out[i] = exp(alpha*invT[i]) for i in [0,n).
+  *
+  * float and double use the runtime-selected SIMD kernel, other types call exp().
+  */
+template<typename Real>
+void exp_product( std::size_t n, Real alpha, Real const *invT, Real *out )
+{
+  using std::exp;
+  for(std::size_t i = 0; i < n; ++i)
+    out[i] = exp( alpha*invT[i] );
+}
+inline void exp_product( std::size_t n, double alpha, double const *invT, double *out ) { ExpKernel<Product,double>::exec( n, alpha, invT, out ); }
+inline void exp_product( std::size_t n, float  alpha, float  const *invT, float  *out ) { ExpKernel<Product,float >::exec( n, alpha, invT, out ); }
+
+}
+}
+}
+
+#endif // include protector
@@ -0,0 +1,194 @@
+#ifndef Integration_detail_VectorizedExpint_hpp
+#define Integration_detail_VectorizedExpint_hpp
+
+/** @file VectorizedExpint.hpp
+  * @brief A vectorizable kernel for the exponential integral E2 in float and double.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  *
+  * The ExponentialIntegral method needs T*E2(alpha/T) at every sample, and
+  * boost::math::expint is a scalar call that costs many times more than exp.
+  * In the Arrhenius problems alpha/T is large (tens to thousands), where the
+  * continued fraction
+  *
+  *   E2(x) = exp(-x) / (x+2 - 1*2/(x+4 - 2*3/(x+6 - ...)))
+  *
+  * converges in a handful of terms. The kernel evaluates a fixed number of terms
+  * (chosen for the smallest argument in the call, so every lane does the same work)
+  * backwards, multiplies by the vectorized exp, and returns exp(-x) too, since the
+  * integrator needs it when the ends of an interval are too close to take the
+  * difference. Arguments below 2, where the continued fraction converges slowly,
+  * are rare in practice and fixed up with boost::math::expint afterwards.
+  */
+
+#include <algorithm>
+
+#include <boost/math/special_functions/expint.hpp>
+
+#include "./VectorizedExp.hpp"
+
+namespace libArrhenius {
+namespace Integration {
+namespace detail {
+
+template<typename Real>
+struct VectorizedExpint {};
+
+template<>
+struct VectorizedExpint<double>
+{
+  /** @brief The number of continued fraction terms that give exp(x)*E2(x) to about an ulp for x >= xmin >= 2. */
+  static int depth( double xmin )
+  {
+    return xmin >= 512 ?  5 :
+           xmin >= 128 ?  6 :
+           xmin >=  64 ?  7 :
+           xmin >=  32 ? 10 :
+           xmin >=  16 ? 13 :
+           xmin >=   8 ? 20 :
+           xmin >=   4 ? 33 : 56;
+  }
+};
+
+template<>
+struct VectorizedExpint<float>
+{
+  static int depth( float xmin )
+  {
+    return xmin >= 128 ?  2 :
+           xmin >=  32 ?  3 :
+           xmin >=  16 ?  5 :
+           xmin >=   8 ?  7 :
+           xmin >=   4 ? 10 : 16;
+  }
+};
+
+// below this the continued fraction is not used.
+template<typename Real>
+constexpr Real expint_cf_min() { return 2; }
+
+/** @brief Computes e[i] = exp(-x) and g[i] = exp(x)*E2(x), with x = Op::apply(alpha,y[i]), for i in [0,n).
+  *
+  * This is the portable kernel, arguments below expint_cf_min() are not handled.
+  * Use expint2_ratio() or expint2_product().
+  */
+template<typename Op, typename Real>
+LIBARRHENIUS_ALWAYS_INLINE void expint2_kernel_generic( std::size_t n, Real alpha, Real const *y, int depth, Real *e, Real *g )
+{
+  // the continued fraction is evaluated backwards as a ratio P/Q, scaled by 1/x so that
+  // the terms stay close to one, which leaves only two divisions. the loop over the terms
+  // is outside of the loop over the samples (in chunks that stay in L1) so that the
+  // inner loops have no control flow and vectorize.
+  const std::size_t chunk = 64;
+  Real s[chunk], P[chunk], Q[chunk];
+  for(std::size_t c = 0; c < n; c += chunk)
+  {
+    std::size_t w = std::min( chunk, n - c );
+    #pragma omp simd
+    for(std::size_t i = 0; i < w; ++i)
+    {
+      Real x = Op::apply( alpha, y[c+i] );
+      s[i] = 1/x;
+      P[i] = 1 + (2 + 2*depth)*s[i];
+      Q[i] = 1;
+      e[c+i] = VectorizedExp<Real>::eval( -x );
+    }
+    for(int k = depth; k >= 1; --k)
+    {
+      Real a = Real(k*(k+1)), b = Real(2*k);
+      #pragma omp simd
+      for(std::size_t i = 0; i < w; ++i)
+      {
+        Real P_next = (1 + b*s[i])*P[i] - a*s[i]*s[i]*Q[i];
+        Q[i] = P[i];
+        P[i] = P_next;
+      }
+    }
+    #pragma omp simd
+    for(std::size_t i = 0; i < w; ++i)
+      g[c+i] = s[i]*Q[i]/P[i];
+  }
+}
+
+#ifdef LIBARRHENIUS_X86_DISPATCH
+template<typename Op, typename Real>
+__attribute__((target("avx2,fma")))
+void expint2_kernel_avx2( std::size_t n, Real alpha, Real const *y, int depth, Real *e, Real *g )
+{
+  expint2_kernel_generic<Op>( n, alpha, y, depth, e, g );
+}
+
+template<typename Op, typename Real>
+__attribute__((target("avx512f")))
+void expint2_kernel_avx512( std::size_t n, Real alpha, Real const *y, int depth, Real *e, Real *g )
+{
+  expint2_kernel_generic<Op>( n, alpha, y, depth, e, g );
+}
+#endif
+
+template<typename Op, typename Real>
+void expint2_kernel_default( std::size_t n, Real alpha, Real const *y, int depth, Real *e, Real *g )
+{
+  expint2_kernel_generic<Op>( n, alpha, y, depth, e, g );
+}
+
+template<typename Op, typename Real>
+struct Expint2Kernel
+{
+  typedef void (*type)( std::size_t, Real, Real const*, int, Real*, Real* );
+
+  static type select()
+  {
+#ifdef LIBARRHENIUS_X86_DISPATCH
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports("avx512f") )
+      return &expint2_kernel_avx512<Op,Real>;
+    if( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") )
+      return &expint2_kernel_avx2<Op,Real>;
+#endif
+    return &expint2_kernel_default<Op,Real>;
+  }
+
+  static void exec( std::size_t n, Real alpha, Real const *y, Real *e, Real *g )
+  {
+    static const type kernel = select();
+
+    Real xmin = std::numeric_limits<Real>::infinity();
+    #pragma omp simd reduction(min:xmin)
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      Real x = Op::apply( alpha, y[i] );
+      xmin = x < xmin ? x : xmin;
+    }
+
+    kernel( n, alpha, y, VectorizedExpint<Real>::depth( std::max( xmin, expint_cf_min<Real>() ) ), e, g );
+
+    if( xmin < expint_cf_min<Real>() )
+    {
+      for(std::size_t i = 0; i < n; ++i)
+      {
+        Real x = Op::apply( alpha, y[i] );
+        if( x < expint_cf_min<Real>() )
+          g[i] = std::exp(x)*boost::math::expint( 2, x );
+      }
+    }
+  }
+};
+
+/** @brief Computes e[i] = exp(-alpha/T[i]) and g[i] = exp(alpha/T[i])*E2(alpha/T[i]) for i in [0,n).
+  *
+  * T*e*g is the T*E2(alpha/T) needed by the ExponentialIntegral method. Only float and
+  * double are supported, alpha/T must not be negative.
+  */
+inline void expint2_ratio( std::size_t n, double alpha, double const *T, double *e, double *g ) { Expint2Kernel<Ratio,double>::exec( n, alpha, T, e, g ); }
+inline void expint2_ratio( std::size_t n, float  alpha, float  const *T, float  *e, float  *g ) { Expint2Kernel<Ratio,float >::exec( n, alpha, T, e, g ); }
+
+/** @brief Same as expint2_ratio, with the argument alpha*invT[i]. */
+inline void expint2_product( std::size_t n, double alpha, double const *invT, double *e, double *g ) { Expint2Kernel<Product,double>::exec( n, alpha, invT, e, g ); }
+inline void expint2_product( std::size_t n, float  alpha, float  const *invT, float  *e, float  *g ) { Expint2Kernel<Product,float >::exec( n, alpha, invT, e, g ); }
+
+}
+}
+}
+
+#endif // include protector
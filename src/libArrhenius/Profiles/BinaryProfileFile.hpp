@@ -0,0 +1,216 @@
+#ifndef Profiles_BinaryProfileFile_hpp
+#define Profiles_BinaryProfileFile_hpp
+
+/** @file BinaryProfileFile.hpp
+  * @brief A binary file format for thermal profiles that can be memory mapped and used without parsing.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  *
+  * The file has the same layout as a ProfileSet, all in the native byte order:
+  *
+  *   header   64 bytes (see BinaryProfileHeader)
+  *   offsets  uint64[profiles+1], profile i occupies [offsets[i],offsets[i+1])
+  *   t        Real[samples], starting on a 64 byte boundary
+  *   T        Real[samples], starting on a 64 byte boundary
+  *
+  * A mapped file hands out pointers straight into the mapping, so the
+  * profiles can be passed to the integrators without being copied.
+  */
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "./ProfileSet.hpp"
+
+namespace libArrhenius {
+
+struct BinaryProfileHeader
+{
+  char magic[8];               // "ARRHPROF"
+  std::uint32_t byte_order;    // 0x01020304, as written by the machine that created the file
+  std::uint32_t version;       // 1
+  std::uint32_t scalar_size;   // sizeof(Real)
+  std::uint32_t reserved;
+  std::uint64_t profiles;
+  std::uint64_t samples;
+  char padding[24];
+
+  static const char* Magic() { return "ARRHPROF"; }
+  static std::uint32_t ByteOrder() { return 0x01020304; }
+  static std::uint32_t Version() { return 1; }
+
+  // byte offsets of the sections in the file.
+  std::uint64_t offsetsPosition() const { return sizeof(BinaryProfileHeader); }
+  std::uint64_t tPosition() const { return align( offsetsPosition() + (profiles+1)*sizeof(std::uint64_t) ); }
+  std::uint64_t TPosition() const { return align( tPosition() + samples*scalar_size ); }
+  std::uint64_t fileSize() const { return TPosition() + samples*scalar_size; }
+
+  static std::uint64_t align( std::uint64_t pos ) { return (pos + 63)/64*64; }
+};
+static_assert( sizeof(BinaryProfileHeader) == 64, "BinaryProfileHeader must be 64 bytes." );
+
+/** Write M profiles to a binary profile file.
+  *
+  * Profile i occupies [offsets[i],offsets[i+1]) in t and T, so offsets must have M+1 entries.
+  */
+template<typename Real>
+void writeBinaryProfiles( std::string const &filename, std::size_t M, std::size_t const *offsets, Real const *t, Real const *T )
+{
+  static_assert( std::is_floating_point<Real>::value, "Binary profile files can only store built-in floating point types." );
+
+  BinaryProfileHeader header;
+  std::memset( &header, 0, sizeof(header) );
+  std::memcpy( header.magic, BinaryProfileHeader::Magic(), sizeof(header.magic) );
+  header.byte_order = BinaryProfileHeader::ByteOrder();
+  header.version = BinaryProfileHeader::Version();
+  header.scalar_size = sizeof(Real);
+  header.profiles = M;
+  header.samples = offsets[M] - offsets[0];
+
+  std::vector<std::uint64_t> offs(M+1);
+  for(std::size_t i = 0; i <= M; ++i)
+    offs[i] = offsets[i] - offsets[0];
+
+  std::ofstream out( filename.c_str(), std::ios::binary );
+  if( !out )
+    throw std::runtime_error("ERROR: Could not open '"+filename+"' for writing.");
+  auto pad = [&](std::uint64_t pos){
+    static const char zeros[64] = {};
+    out.write( zeros, pos - static_cast<std::uint64_t>(out.tellp()) );
+  };
+  out.write( reinterpret_cast<char const*>(&header), sizeof(header) );
+  out.write( reinterpret_cast<char const*>(offs.data()), offs.size()*sizeof(std::uint64_t) );
+  pad( header.tPosition() );
+  out.write( reinterpret_cast<char const*>(t + offsets[0]), header.samples*sizeof(Real) );
+  pad( header.TPosition() );
+  out.write( reinterpret_cast<char const*>(T + offsets[0]), header.samples*sizeof(Real) );
+  if( !out )
+    throw std::runtime_error("ERROR: Could not write to '"+filename+"'.");
+}
+
+template<typename Real>
+void writeBinaryProfiles( std::string const &filename, ProfileSet<Real> const &profiles )
+{
+  writeBinaryProfiles( filename, profiles.size(), profiles.offsetData(), profiles.tData(), profiles.TData() );
+}
+
+template<typename Real>
+void writeBinaryProfile( std::string const &filename, std::size_t N, Real const *t, Real const *T )
+{
+  std::size_t offsets[2] = {0, N};
+  writeBinaryProfiles( filename, 1, offsets, t, T );
+}
+
+/** Returns true if filename starts with the binary profile file magic string. */
+inline bool isBinaryProfileFile( std::string const &filename )
+{
+  char magic[8];
+  std::ifstream in( filename.c_str(), std::ios::binary );
+  return in.read( magic, sizeof(magic) ) && std::memcmp( magic, BinaryProfileHeader::Magic(), sizeof(magic) ) == 0;
+}
+
+/** @class MappedProfileFile
+  * @brief Memory maps a binary profile file and gives access to its profiles without copying them.
+  * @author C.D. Clark III
+  *
+  * Has the same accessors as ProfileSet. The pointers are only valid while the
+  * MappedProfileFile exists.
+  */
+template<typename Real>
+class MappedProfileFile
+{
+  protected:
+    boost::interprocess::file_mapping mapping;
+    boost::interprocess::mapped_region region;
+    BinaryProfileHeader const *header = nullptr;
+    std::size_t const *offsets = nullptr;
+    Real const *tdata = nullptr, *Tdata = nullptr;
+
+    static_assert( std::is_floating_point<Real>::value, "Binary profile files can only store built-in floating point types." );
+    static_assert( sizeof(std::size_t) == sizeof(std::uint64_t), "Mapping binary profile files requires a 64-bit size_t." );
+
+  public:
+    explicit MappedProfileFile( std::string const &filename )
+    {
+      try {
+        mapping = boost::interprocess::file_mapping( filename.c_str(), boost::interprocess::read_only );
+        region = boost::interprocess::mapped_region( mapping, boost::interprocess::read_only );
+      } catch( std::exception &e ) {
+        throw std::runtime_error("ERROR: Could not map '"+filename+"': "+e.what());
+      }
+
+      char const *data = static_cast<char const*>( region.get_address() );
+      std::size_t size = region.get_size();
+      if( size < sizeof(BinaryProfileHeader) )
+        throw std::runtime_error("ERROR: '"+filename+"' is too small to be a binary profile file.");
+      header = reinterpret_cast<BinaryProfileHeader const*>( data );
+      if( std::memcmp( header->magic, BinaryProfileHeader::Magic(), sizeof(header->magic) ) != 0 )
+        throw std::runtime_error("ERROR: '"+filename+"' is not a binary profile file.");
+      if( header->byte_order != BinaryProfileHeader::ByteOrder() )
+        throw std::runtime_error("ERROR: '"+filename+"' was written on a machine with a different byte order.");
+      if( header->version != BinaryProfileHeader::Version() )
+        throw std::runtime_error("ERROR: '"+filename+"' has an unsupported version.");
+      if( header->scalar_size != sizeof(Real) )
+        throw std::runtime_error("ERROR: '"+filename+"' stores "+std::to_string(header->scalar_size)+" byte values, but "+std::to_string(sizeof(Real))+" byte values were requested.");
+      // check the counts against the size of the file before computing the positions of the sections, so they can't wrap around.
+      if( header->profiles >= (size - header->offsetsPosition())/sizeof(std::uint64_t) || header->samples > size/header->scalar_size )
+        throw std::runtime_error("ERROR: '"+filename+"' has a corrupt header.");
+      if( size < header->fileSize() )
+        throw std::runtime_error("ERROR: '"+filename+"' is truncated.");
+
+      offsets = reinterpret_cast<std::size_t const*>( data + header->offsetsPosition() );
+      tdata = reinterpret_cast<Real const*>( data + header->tPosition() );
+      Tdata = reinterpret_cast<Real const*>( data + header->TPosition() );
+
+      if( offsets[0] != 0 || offsets[header->profiles] != header->samples )
+        throw std::runtime_error("ERROR: '"+filename+"' has a corrupt offset table.");
+      for(std::size_t i = 0; i < header->profiles; ++i)
+        if( offsets[i+1] < offsets[i] )
+          throw std::runtime_error("ERROR: '"+filename+"' has a corrupt offset table.");
+    }
+
+    virtual ~MappedProfileFile (){};
+
+    std::size_t size() const { return header->profiles; }
+    std::size_t samples() const { return header->samples; }
+
+    std::size_t N( std::size_t i ) const { return offsets[i+1] - offsets[i]; }
+    Real const* t( std::size_t i ) const { return tdata + offsets[i]; }
+    Real const* T( std::size_t i ) const { return Tdata + offsets[i]; }
+
+    Real const* tData() const { return tdata; }
+    Real const* TData() const { return Tdata; }
+    std::size_t const* offsetData() const { return offsets; }
+
+  protected:
+};
+
+/** Returns the size of the values stored in a binary profile file (4 for float, 8 for double). */
+inline std::uint32_t binaryScalarSize( std::string const &filename )
+{
+  BinaryProfileHeader header;
+  std::ifstream in( filename.c_str(), std::ios::binary );
+  if( !in.read( reinterpret_cast<char*>(&header), sizeof(header) ) )
+    throw std::runtime_error("ERROR: '"+filename+"' is too small to be a binary profile file.");
+  return header.scalar_size;
+}
+
+/** Returns the number of profiles in a binary profile file. The file is validated. */
+inline std::size_t binaryProfileCount( std::string const &filename )
+{
+  if( binaryScalarSize( filename ) == sizeof(float) )
+    return MappedProfileFile<float>( filename ).size();
+  return MappedProfileFile<double>( filename ).size();
+}
+
+}
+
+#endif // include protector
@@ -0,0 +1,73 @@
+#ifndef Profiles_PreparedProfile_hpp
+#define Profiles_PreparedProfile_hpp
+
+/** @file PreparedProfile.hpp
+  * @brief A thermal profile with the quantities used by the integrators precomputed.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
+namespace libArrhenius {
+
+/** @class PreparedProfile
+  * @brief Stores a thermal profile along with its time steps, inverse temperatures, and temperature rise.
+  * @author C.D. Clark III
+  *
+  * Fits evaluate the same profile hundreds of times, and every evaluation needs
+  * t[i]-t[i-1] and 1/T[i] (and the threshold calculator needs T[i]-T[0]). A prepared
+  * profile computes these once. Each quantity is stored in its own cache-line aligned
+  * array so the integration kernels can stream through them.
+  *
+  * dt()[0] is zero, and dt()[i] = t[i]-t[i-1] for i > 0.
+  */
+template<typename Real>
+class PreparedProfile
+{
+  public:
+    typedef std::vector<Real, boost::alignment::aligned_allocator<Real,64>> array_type;
+
+  protected:
+    array_type tdata, Tdata, dtdata, invTdata, dTdata;
+
+  public:
+    PreparedProfile (){};
+    PreparedProfile ( std::size_t N_, Real const *t_, Real const *T_ ) { prepare(N_,t_,T_); }
+    virtual ~PreparedProfile (){};
+
+    void prepare( std::size_t N_, Real const *t_, Real const *T_ )
+    {
+      tdata.assign( t_, t_+N_ );
+      Tdata.assign( T_, T_+N_ );
+      dtdata.resize( N_ );
+      invTdata.resize( N_ );
+      dTdata.resize( N_ );
+      for(std::size_t i = 0; i < N_; ++i)
+      {
+        dtdata[i] = i > 0 ? Real(t_[i] - t_[i-1]) : Real(0);
+        invTdata[i] = 1/T_[i];
+        dTdata[i] = T_[i] - T_[0];
+      }
+    }
+
+    std::size_t size() const { return tdata.size(); }
+
+    Real const* t() const { return tdata.data(); }
+    Real const* T() const { return Tdata.data(); }
+    /** time steps, t[i] - t[i-1] */
+    Real const* dt() const { return dtdata.data(); }
+    /** inverse temperatures, 1/T[i] */
+    Real const* invT() const { return invTdata.data(); }
+    /** temperature rise, T[i] - T[0] */
+    Real const* dT() const { return dTdata.data(); }
+
+  protected:
+};
+
+}
+
+#endif // include protector
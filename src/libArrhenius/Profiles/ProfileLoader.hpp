@@ -0,0 +1,229 @@
+#ifndef Profiles_ProfileLoader_hpp
+#define Profiles_ProfileLoader_hpp
+
+/** @file ProfileLoader.hpp
+  * @brief Reads thermal profile files concurrently, in the background.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Utils/ReadFunction.hpp"
+#include "./BinaryProfileFile.hpp"
+
+namespace libArrhenius {
+
+/** @class ProfileLoader
+  * @brief Loads a list of thermal profile files on a pool of threads and hands them out in order.
+  * @author C.D. Clark III
+  *
+  * Parsing a text profile (especially into a multiprecision type) can take as long as
+  * integrating it, so the files are read and parsed on background threads while the caller
+  * works on the profiles that have already been loaded.
+  *
+  * At most capacity files are loaded ahead of the caller, so memory use is bounded no matter
+  * how many files there are. Profiles are returned by next() in the order the files were given.
+  * If a file can't be loaded, the exception is rethrown by next() when that file's turn comes.
+  *
+  * Binary profile files (see BinaryProfileFile.hpp) are detected and read from a mapping,
+  * without parsing. A binary file that holds several profiles is expanded into one profile
+  * per entry, named "filename:i". Files are only opened by the loader threads, so the
+  * number of profiles is not known until they have been loaded.
+  */
+template<typename Real>
+class ProfileLoader
+{
+  public:
+    struct Profile
+    {
+      std::size_t index = 0;
+      std::string filename;
+      std::vector<Real> t, T;
+    };
+
+  protected:
+    // the profiles of one file. next is the first one that hasn't been returned yet.
+    struct Slot
+    {
+      bool ready = false;
+      std::vector<Profile> profiles;
+      std::size_t next = 0;
+      std::exception_ptr error;
+    };
+
+    std::vector<std::string> filenames;
+    std::vector<Slot> slots;
+    std::size_t claimed = 0, consumed = 0, returned = 0;
+    bool stopped = false;
+
+    std::mutex mutex;
+    std::condition_variable slot_ready, slot_free;
+    std::vector<std::thread> workers;
+
+  public:
+    /** Start loading the files.
+      *
+      * @param threads the number of loader threads. zero uses one thread per core.
+      * @param capacity the number of files that can be loaded ahead of the caller. zero uses two per thread.
+      */
+    ProfileLoader( std::vector<std::string> filenames_, std::size_t threads = 0, std::size_t capacity = 0 )
+    :filenames(std::move(filenames_))
+    {
+      if( threads == 0 )
+        threads = std::max( 1u, std::thread::hardware_concurrency() );
+      threads = std::max( std::size_t(1), std::min( threads, filenames.size() ) );
+      if( capacity == 0 )
+        capacity = 2*threads;
+      slots.resize( std::max( capacity, threads ) );
+
+      for(std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back( [this](){ work(); } );
+    }
+
+    ProfileLoader( ProfileLoader const & ) = delete;
+    ProfileLoader& operator=( ProfileLoader const & ) = delete;
+
+    virtual ~ProfileLoader ()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+      }
+      slot_free.notify_all();
+      for( auto &w : workers )
+        w.join();
+    };
+
+    /** The number of files. A binary file can hold more than one profile, so this is not the number of profiles. */
+    std::size_t size() const { return filenames.size(); }
+
+    /** Waits for the next profile and moves it into profile. Returns false when all of the profiles have been returned. */
+    bool next( Profile &profile )
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while( consumed < filenames.size() )
+      {
+        Slot &slot = slots[consumed % slots.size()];
+        slot_ready.wait( lock, [&](){ return slot.ready; } );
+        std::exception_ptr error = slot.error;
+        bool found = !error && slot.next < slot.profiles.size();
+        if( found )
+        {
+          profile = std::move(slot.profiles[slot.next++]);
+          profile.index = returned++;
+          if( slot.next < slot.profiles.size() )
+            return true;
+        }
+        if( error )
+          ++returned;
+
+        // all of the file's profiles have been returned (a binary file may not have any), so its slot can be reused.
+        slot = Slot();
+        ++consumed;
+        lock.unlock();
+        slot_free.notify_all();
+        if( error )
+          std::rethrow_exception(error);
+        if( found )
+          return true;
+        lock.lock();
+      }
+      return false;
+    }
+
+    /** Reads a single profile file. If it is a binary profile file, the first profile is read. */
+    static void load( std::string const &filename, std::vector<Real> &t, std::vector<Real> &T )
+    {
+      if( isBinaryProfileFile( filename ) )
+        load( filename, 0, t, T );
+      else
+        RUC::ReadFunction(filename, t, T);
+    }
+
+    /** Reads profile i of a binary profile file, converting it to Real. */
+    static void load( std::string const &filename, std::size_t i, std::vector<Real> &t, std::vector<Real> &T )
+    {
+      if( binaryScalarSize( filename ) == sizeof(float) )
+        copy( MappedProfileFile<float>( filename ), filename, i, t, T );
+      else
+        copy( MappedProfileFile<double>( filename ), filename, i, t, T );
+    }
+
+  protected:
+    void work()
+    {
+      while( true )
+      {
+        std::size_t i;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          // a file can't be claimed until the slot it will be stored in has been consumed.
+          slot_free.wait( lock, [&](){ return stopped || claimed == filenames.size() || claimed < consumed + slots.size(); } );
+          if( stopped || claimed == filenames.size() )
+            return;
+          i = claimed++;
+        }
+
+        Slot slot;
+        try {
+          loadAll( filenames[i], slot.profiles );
+        } catch( ... ) {
+          slot.error = std::current_exception();
+        }
+        slot.ready = true;
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          slots[i % slots.size()] = std::move(slot);
+        }
+        slot_ready.notify_all();
+      }
+    }
+
+    // reads every profile in a file. a binary file is only mapped once.
+    static void loadAll( std::string const &filename, std::vector<Profile> &profiles )
+    {
+      if( !isBinaryProfileFile( filename ) )
+      {
+        profiles.resize(1);
+        profiles[0].filename = filename;
+        RUC::ReadFunction(filename, profiles[0].t, profiles[0].T);
+      }
+      else if( binaryScalarSize( filename ) == sizeof(float) )
+        copyAll( MappedProfileFile<float>( filename ), filename, profiles );
+      else
+        copyAll( MappedProfileFile<double>( filename ), filename, profiles );
+    }
+
+    template<typename File>
+    static void copyAll( File const &file, std::string const &filename, std::vector<Profile> &profiles )
+    {
+      profiles.resize( file.size() );
+      for(std::size_t j = 0; j < file.size(); ++j)
+      {
+        profiles[j].filename = file.size() > 1 ? filename + ":" + std::to_string(j) : filename;
+        copy( file, filename, j, profiles[j].t, profiles[j].T );
+      }
+    }
+
+    template<typename File>
+    static void copy( File const &file, std::string const &filename, std::size_t i, std::vector<Real> &t, std::vector<Real> &T )
+    {
+      if( i >= file.size() )
+        throw std::runtime_error("ERROR: '"+filename+"' does not have a profile "+std::to_string(i)+".");
+      t.assign( file.t(i), file.t(i) + file.N(i) );
+      T.assign( file.T(i), file.T(i) + file.N(i) );
+    }
+};
+
+}
+
+#endif // include protector
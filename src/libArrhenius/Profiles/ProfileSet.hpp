@@ -0,0 +1,77 @@
+#ifndef Profiles_ProfileSet_hpp
+#define Profiles_ProfileSet_hpp
+
+/** @file ProfileSet.hpp
+  * @brief A set of thermal profiles stored in one contiguous buffer.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <cstddef>
+#include <vector>
+
+namespace libArrhenius {
+
+/** @class ProfileSet
+  * @brief Stores many thermal profiles in a structure-of-arrays layout.
+  * @author C.D. Clark III
+  *
+  * All time values are stored back-to-back in one array, and all temperature
+  * values in another. An offsets array gives the index of the first sample for
+  * each profile, with one extra entry at the end holding the total number of
+  * samples, so profile i occupies [offsets[i],offsets[i+1]).
+  */
+template<typename Real>
+class ProfileSet
+{
+  protected:
+    std::vector<Real> tdata, Tdata;
+    std::vector<std::size_t> offsets;
+
+  public:
+    ProfileSet ():offsets(1,0){};
+    virtual ~ProfileSet (){};
+
+    /** Copy a profile into the set. */
+    void addProfile( std::size_t N_, Real const *t_, Real const *T_ )
+    {
+      tdata.insert( tdata.end(), t_, t_+N_ );
+      Tdata.insert( Tdata.end(), T_, T_+N_ );
+      offsets.push_back( offsets.back() + N_ );
+    }
+
+    void reserve( std::size_t profiles, std::size_t samples )
+    {
+      offsets.reserve( profiles+1 );
+      tdata.reserve( samples );
+      Tdata.reserve( samples );
+    }
+
+    void clear()
+    {
+      tdata.clear();
+      Tdata.clear();
+      offsets.assign(1,0);
+    }
+
+    /** The number of profiles in the set. */
+    std::size_t size() const { return offsets.size()-1; }
+    /** The total number of samples in all profiles. */
+    std::size_t samples() const { return offsets.back(); }
+
+    std::size_t N( std::size_t i ) const { return offsets[i+1] - offsets[i]; }
+    Real const* t( std::size_t i ) const { return tdata.data() + offsets[i]; }
+    Real const* T( std::size_t i ) const { return Tdata.data() + offsets[i]; }
+    Real* t( std::size_t i ) { return tdata.data() + offsets[i]; }
+    Real* T( std::size_t i ) { return Tdata.data() + offsets[i]; }
+
+    Real const* tData() const { return tdata.data(); }
+    Real const* TData() const { return Tdata.data(); }
+    std::size_t const* offsetData() const { return offsets.data(); }
+
+  protected:
+};
+
+}
+
+#endif // include protector
@@ -0,0 +1,196 @@
+#ifndef Stats_hpp
+#define Stats_hpp
+
+/** @file Stats.hpp
+  * @brief Optional counters and phase timers for the integrators, threshold calculator and fitters.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  *
+  * The instrumentation is compiled in when LIBARRHENIUS_STATS is defined (see the
+  * LIBARRHENIUS_ENABLE_STATS CMake option). Otherwise the hooks expand to nothing
+  * and Stats::report() returns zeros. Define it for every translation unit in a
+  * program or none of them.
+  *
+  * Example:
+  *
+  *   Stats::reset();
+  *   auto coefficients = fit.exec();
+  *   Stats::report().print(std::cerr);
+  */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+namespace libArrhenius {
+namespace Stats {
+
+enum Counter
+{
+  Integrations,        // Omega (or log(Omega)) evaluations, one per set of coefficients.
+  Samples,             // profile samples read by the integrations, once per pass over a profile.
+  ExpCalls,            // exponentials evaluated, one per sample per set of coefficients.
+  RootIterations,      // iterations of the root finders (upper bound on Ea, thresholds).
+  MinimizerIterations, // iterations of Brent's method in the fitters.
+  CostEvaluations,     // calls to the fitters' cost functions.
+  ThresholdSolves,     // thresholds computed by the ThresholdCalculator.
+  NumCounters
+};
+
+enum Phase
+{
+  Fit,              // ArrheniusFit::exec.
+  UpperBoundSearch, // bracketing the largest usable Ea for each profile.
+  Scan,             // the rough scan for the minimum over a log-scale Ea grid.
+  EaMinimization,   // Brent's method on Ea.
+  AMinimization,    // Brent's method on A, which includes the threshold solves.
+  Threshold,        // ThresholdCalculator calls.
+  NumPhases
+};
+
+#ifdef LIBARRHENIUS_STATS
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+inline char const* name( Counter c )
+{
+  static char const* const names[] = { "integrations", "samples", "exp calls", "root iterations", "minimizer iterations", "cost evaluations", "threshold solves" };
+  return names[c];
+}
+
+inline char const* name( Phase p )
+{
+  static char const* const names[] = { "fit", "Ea upper bound search", "Ea scan", "Ea minimization", "A minimization", "threshold" };
+  return names[p];
+}
+
+/** A snapshot of the counters and timers. */
+struct Report
+{
+  std::array<std::uint64_t,NumCounters> counts{};
+  std::array<std::uint64_t,NumPhases> calls{};
+  std::array<double,NumPhases> seconds{};
+
+  std::uint64_t operator[]( Counter c ) const { return counts[c]; }
+
+  void print( std::ostream &out ) const
+  {
+    if( !enabled )
+    {
+      out << "Statistics are not available, libArrhenius was compiled without LIBARRHENIUS_STATS.\n";
+      return;
+    }
+    out << "Counters:\n";
+    for( int c = 0; c < NumCounters; ++c )
+      out << "  " << std::left << std::setw(24) << name(static_cast<Counter>(c)) << std::right << std::setw(16) << counts[c] << "\n";
+    out << "Phases (wall time, phases can be nested):\n";
+    out << "  " << std::left << std::setw(24) << "phase" << std::right << std::setw(16) << "calls" << std::setw(16) << "seconds" << "\n";
+    for( int p = 0; p < NumPhases; ++p )
+      out << "  " << std::left << std::setw(24) << name(static_cast<Phase>(p)) << std::right << std::setw(16) << calls[p] << std::setw(16) << seconds[p] << "\n";
+  }
+};
+
+namespace detail {
+
+struct Registry
+{
+  std::array<std::atomic<std::uint64_t>,NumCounters> counts;
+  std::array<std::atomic<std::uint64_t>,NumPhases> calls, nanoseconds;
+
+  Registry() { reset(); }
+
+  void reset()
+  {
+    for( auto &c : counts ) c.store(0);
+    for( auto &c : calls ) c.store(0);
+    for( auto &c : nanoseconds ) c.store(0);
+  }
+};
+
+inline Registry& registry()
+{
+  static Registry r;
+  return r;
+}
+
+}
+
+/** Adds n to a counter. Safe to call from several threads. */
+inline void add( Counter c, std::uint64_t n = 1 )
+{
+  detail::registry().counts[c].fetch_add( n, std::memory_order_relaxed );
+}
+
+/** Records a pass over a profile with the given number of samples that evaluates Omega for several sets of coefficients.
+  *
+  * The samples are only read once, however many sets of coefficients the pass evaluates.
+  */
+inline void integrations( std::uint64_t samples, std::uint64_t evaluations = 1 )
+{
+  add( Integrations, evaluations );
+  add( Samples, samples );
+  add( ExpCalls, samples*evaluations );
+}
+
+/** Adds the time between construction and destruction to a phase. */
+class ScopedTimer
+{
+  protected:
+    Phase phase;
+    std::chrono::steady_clock::time_point start;
+
+  public:
+    explicit ScopedTimer( Phase p )
+    :phase(p), start(std::chrono::steady_clock::now())
+    {}
+
+    ScopedTimer( ScopedTimer const& ) = delete;
+    ScopedTimer& operator=( ScopedTimer const& ) = delete;
+
+    ~ScopedTimer()
+    {
+      auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start );
+      detail::registry().calls[phase].fetch_add( 1, std::memory_order_relaxed );
+      detail::registry().nanoseconds[phase].fetch_add( elapsed.count(), std::memory_order_relaxed );
+    }
+};
+
+inline Report report()
+{
+  Report r;
+  for( int c = 0; c < NumCounters; ++c )
+    r.counts[c] = detail::registry().counts[c].load();
+  for( int p = 0; p < NumPhases; ++p )
+  {
+    r.calls[p] = detail::registry().calls[p].load();
+    r.seconds[p] = detail::registry().nanoseconds[p].load()*1e-9;
+  }
+  return r;
+}
+
+inline void reset()
+{
+  detail::registry().reset();
+}
+
+}
+}
+
+// the hooks used inside of the library. they compile to nothing (and their arguments
+// are not evaluated) unless LIBARRHENIUS_STATS is defined.
+#ifdef LIBARRHENIUS_STATS
+#define LIBARRHENIUS_STATS_ADD(counter, n) ::libArrhenius::Stats::add( ::libArrhenius::Stats::counter, n )
+#define LIBARRHENIUS_STATS_INTEGRATIONS(samples, evaluations) ::libArrhenius::Stats::integrations( samples, evaluations )
+#define LIBARRHENIUS_STATS_TIMER(phase) ::libArrhenius::Stats::ScopedTimer libArrhenius_stats_timer_##phase( ::libArrhenius::Stats::phase )
+#else
+#define LIBARRHENIUS_STATS_ADD(counter, n) ((void)0)
+#define LIBARRHENIUS_STATS_INTEGRATIONS(samples, evaluations) ((void)0)
+#define LIBARRHENIUS_STATS_TIMER(phase) ((void)0)
+#endif
+
+#endif // include protector
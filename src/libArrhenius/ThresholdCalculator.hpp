@@ -1,7 +1,16 @@
 #ifndef ThresholdCalculator_hpp
 #define ThresholdCalculator_hpp
 
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
 #include <utility>
+#include <vector>
+
+#include "./Profiles/PreparedProfile.hpp"
+#include "./Profiles/ProfileSet.hpp"
+#include "./Stats.hpp"
 
 #include <boost/math/tools/roots.hpp>
 using boost::math::tools::bracket_and_solve_root;
@@ -30,6 +39,7 @@ class ThresholdCalculator<Integrator<Real,Method>> : public Integrator<Real,Meth
 {
   protected:
     Real ThresholdOmega = 1;
+    bool UseDerivatives = true;
 
   public:
     template<typename ...Args>
@@ -40,15 +50,255 @@ class ThresholdCalculator<Integrator<Real,Method>> : public Integrator<Real,Meth
 
     virtual ~ThresholdCalculator () {};
 
+    /** Scratch buffers used while solving for a threshold.
+      *
+      * The buffers grow to fit the largest profile they have been used with
+      * and are reused after that, so repeated solves don't allocate.
+      * A workspace must not be shared between threads.
+      */
+    struct Workspace
+    {
+      std::vector<Real> dT, TT;
+    };
+
     void setThresholdOmega(Real O){ ThresholdOmega = O; }
     Real getThresholdOmega() const {return ThresholdOmega;}
+
+    /** Use Halley's method to solve for thresholds when the integrator can compute derivatives.
+      *
+      * The trapezoid integrators can compute log(Omega) and its first two derivatives with
+      * respect to the scaling factor in one pass over the profile, so a threshold only takes a
+      * handful of integrations. Otherwise, or if Halley's method fails, the threshold is
+      * bracketed and solved for with bracket_and_solve_root. Enabled by default.
+      */
+    void setUseDerivatives(bool u){ UseDerivatives = u; }
+    bool getUseDerivatives() const {return UseDerivatives;}
+
+    /** Calculate the threshold for a profile.
+      *
+      * This uses a per-thread workspace, so calling it repeatedly only allocates
+      * when a profile is larger than any previous one.
+      */
     Real operator()(size_t N, Real const *t, Real const *T) const
     {
-      Real *dT = new Real[N];
-      Real *TT = new Real[N];
+      LIBARRHENIUS_STATS_TIMER(Threshold);
+      return this->operator()(N, t, T, local_workspace());
+    }
+
+    Real operator()(size_t N, Real const *t, Real const *T, Workspace &ws) const
+    {
+      if( ws.dT.size() < N )
+        ws.dT.resize(N);
 
       for(size_t i = 0; i < N; i++)
-        dT[i] = T[i] - T[0];
+        ws.dT[i] = T[i] - T[0];
+
+      return solve(N, t, T[0], ws.dT.data(), ws);
+    }
+
+    /** Calculate the threshold for a prepared profile, which already stores the temperature rise T[i] - T[0]. */
+    Real operator()(PreparedProfile<Real> const &profile) const
+    {
+      LIBARRHENIUS_STATS_TIMER(Threshold);
+      return this->operator()(profile, local_workspace());
+    }
+
+    Real operator()(PreparedProfile<Real> const &profile, Workspace &ws) const
+    {
+      return solve(profile.size(), profile.t(), profile.T()[0], profile.dT(), ws);
+    }
+
+    /** Calculate the thresholds for M profiles stored back-to-back in t and T.
+      *
+      * Profile i occupies [offsets[i],offsets[i+1]) in t and T, so offsets must have M+1 entries.
+      * The profiles are distributed across threads, each with its own workspace, and the thresholds
+      * are written to thresholds[0..M) in the same order as the profiles. If a threshold can't be
+      * calculated, the remaining profiles are skipped and the exception thrown for the failed profile
+      * is rethrown once the running ones are done.
+      */
+    void operator()(std::size_t M, std::size_t const *offsets, Real const *t, Real const *T, Real *thresholds) const
+    {
+      for_each_profile( M, thresholds, [&](std::size_t i, Workspace &ws){
+          return this->operator()(offsets[i+1]-offsets[i], t+offsets[i], T+offsets[i], ws); } );
+    }
+
+    /** Calculate the thresholds for the profiles in a ProfileSet, or anything else that stores them the same way (i.e. a MappedProfileFile). */
+    template<typename Profiles>
+    auto operator()(Profiles const &profiles) const -> decltype( profiles.offsetData(), std::vector<Real>() )
+    {
+      std::vector<Real> thresholds(profiles.size());
+      this->operator()(profiles.size(), profiles.offsetData(), profiles.tData(), profiles.TData(), thresholds.data());
+      return thresholds;
+    }
+
+    std::vector<Real> operator()(std::vector<PreparedProfile<Real>> const &profiles) const
+    {
+      std::vector<Real> thresholds(profiles.size());
+      for_each_profile( profiles.size(), thresholds.data(), [&](std::size_t i, Workspace &ws){
+          return this->operator()(profiles[i], ws); } );
+      return thresholds;
+    }
+
+    Real Omega(size_t N, Real const *t, Real const *T) const
+    {
+      return Integrator<Real,Method>::operator()(N,t,T);
+    }
+
+    Real Omega(PreparedProfile<Real> const &profile) const
+    {
+      return Integrator<Real,Method>::operator()(profile);
+    }
+
+  protected:
+    // evaluate out[i] = f(i,ws) for i in [0,M) in parallel. exceptions can't leave an OpenMP
+    // region, so they are caught and the first one (in profile order) is rethrown at the end.
+    // once a profile fails, the profiles that haven't been started yet are skipped. failures
+    // are expensive (the solver gives up), and the fitters call this inside of try blocks.
+    template<typename F>
+    void for_each_profile(std::size_t M, Real *out, F f) const
+    {
+      LIBARRHENIUS_STATS_TIMER(Threshold);
+      std::vector<std::exception_ptr> errors(M);
+      bool failed = false;
+      #pragma omp parallel if(M > 1)
+      {
+        Workspace ws;
+        #pragma omp for schedule(dynamic)
+        for(std::size_t i = 0; i < M; ++i)
+        {
+          bool skip;
+          #pragma omp atomic read
+          skip = failed;
+          if( skip )
+            continue;
+          try {
+            out[i] = f(i,ws);
+          } catch(...) {
+            errors[i] = std::current_exception();
+            #pragma omp atomic write
+            failed = true;
+          }
+        }
+      }
+      for(auto &e : errors)
+        if( e )
+          std::rethrow_exception(e);
+    }
+
+    static Workspace& local_workspace()
+    {
+      thread_local Workspace ws;
+      return ws;
+    }
+
+    // solve for the threshold with Halley's method. the iteration is kept inside of a bracket on the
+    // root, and inside of the range of x where all temperatures are positive. returns false if it
+    // fails, for example because log(Omega) is not increasing.
+    template<typename I = Integrator<Real,Method>>
+    auto halley_solve(size_t N, Real const *t, Real T0, Real const *dT, Real &x, int) const
+      -> decltype( std::declval<I const&>().scaledLogOmega(N,t,T0,x,dT), bool() )
+    {
+      using std::abs;
+      Real inf = std::numeric_limits<Real>::infinity();
+      if( !(T0 > 0) )
+        return false;
+
+      // the range of x that keeps T0 + x*dT[i] positive
+      Real lb = -inf, ub = inf;
+      for(size_t i = 1; i < N; i++)
+      {
+        if( dT[i] > 0 && -T0/dT[i] > lb )
+          lb = -T0/dT[i];
+        if( dT[i] < 0 && -T0/dT[i] < ub )
+          ub = -T0/dT[i];
+      }
+
+      Real logThresholdOmega = log(ThresholdOmega);
+      eps_tolerance<Real> tol( std::numeric_limits<Real>::digits - 3 ); // same precision as the bracketing solver.
+      bool have_lb = false, have_ub = false; // set when lb/ub are points where f < 0 / f > 0.
+      int edge_steps = 0; // consecutive steps taken toward the edge of the domain.
+
+      // CAREFULE: make sure initial guess is not an integer!
+      x = 1.0;
+      for(int it = 0; it < 100; ++it)
+      {
+        Real f0, f1, f2;
+        std::tie(f0,f1,f2) = I::scaledLogOmega(N,t,T0,x,dT);
+        LIBARRHENIUS_STATS_ADD(RootIterations, 1);
+        LIBARRHENIUS_STATS_INTEGRATIONS(N, 1);
+        f0 -= logThresholdOmega;
+
+        if( !(f1 > 0) || f0 != f0 )
+          return false;
+        if( f0 == 0 )
+          return true;
+        if( f0 < 0 )
+        { lb = x; have_lb = true; }
+        else
+        { ub = x; have_ub = true; }
+
+        // Halley step, falling back to a Newton step if the correction is not usable.
+        Real dx = f0/f1;
+        Real denom = 1 - dx*f2/(2*f1);
+        if( denom > 0 )
+          dx /= denom;
+        Real x_new = x - dx;
+
+        // bisect if the step leaves the bracket. if we don't have a bracket yet, move
+        // half way to the edge of the domain, or double the step if there is no edge.
+        // only Halley steps can converge, otherwise we would converge to the edge of the
+        // domain when there is no root. if we keep heading for the edge, there probably
+        // isn't a root, so give up and let the bracketing solver decide.
+        bool done = tol(x, x_new);
+        if( !(x_new > lb && x_new < ub) )
+        {
+          done = false;
+          Real lim = x_new > x ? ub : lb;
+          if( have_lb && have_ub )
+          {
+            x_new = (lb + ub)/2;
+          }
+          else
+          {
+            if( ++edge_steps > 16 )
+              return false;
+            if( lim == inf || lim == -inf )
+              x_new = x + 2*(x_new > x ? 1 : -1)*(abs(x) + 1);
+            else
+              x_new = (x + lim)/2;
+          }
+        }
+        else
+        {
+          edge_steps = 0;
+        }
+
+        done = done || (have_lb && have_ub && tol(lb, ub));
+        x = x_new;
+        if( done )
+          return true;
+      }
+
+      return false;
+    }
+
+    template<typename I = Integrator<Real,Method>>
+    bool halley_solve(size_t N, Real const *t, Real T0, Real const *dT, Real &x, long) const
+    {
+      return false;
+    }
+
+    // find the scaling factor x for which the profile T0 + x*dT[i] reaches the threshold.
+    Real solve(size_t N, Real const *t, Real T0, Real const *dT, Workspace &ws) const
+    {
+      LIBARRHENIUS_STATS_ADD(ThresholdSolves, 1);
+      Real x;
+      if( UseDerivatives && halley_solve(N, t, T0, dT, x, 0) )
+        return x;
+
+      if( ws.TT.size() < N )
+        ws.TT.resize(N);
+      Real *TT = ws.TT.data();
 
       // the function that will be rooted
       // should take a single argument and return
@@ -57,10 +307,11 @@ class ThresholdCalculator<Integrator<Real,Method>> : public Integrator<Real,Meth
 
         // create the temperature profile that will be evaluated.
         for(size_t i = 0; i < N; i++)
-          TT[i] = T[0] + x*dT[i];
+          TT[i] = T0 + x*dT[i];
         
         // calculate damage parameter
         Real Omega = Integrator<Real,Method>::operator()(N,t,TT);
+        LIBARRHENIUS_STATS_INTEGRATIONS(N, 1);
 
         // damage will be between zero and infinity. we are looking for
         // the value of x that will give Omega = ThresholdOmega, so return log of Omega/ThresholdOmega.
@@ -82,21 +333,17 @@ class ThresholdCalculator<Integrator<Real,Method>> : public Integrator<Real,Meth
         guess = -1.0;
 
       auto min_max = bracket_and_solve_root(f, guess, factor, true, tol, it);
+      LIBARRHENIUS_STATS_ADD(RootIterations, it);
 
-      // clean up our memory
-      delete[] dT;
-      delete[] TT;
-
-      return (min_max.first + min_max.second)/2;
-      
-    }
+      // if there is no root (the profile causes more damage than the threshold no matter
+      // how far it is scaled down) the bracket can run off to infinity.
+      using std::abs;
+      x = (min_max.first + min_max.second)/2;
+      if( !(abs(x) < std::numeric_limits<Real>::infinity()) )
+        throw std::runtime_error("ERROR: Could not find a threshold for the thermal profile.");
 
-    Real Omega(size_t N, Real const *t, Real const *T) const
-    {
-      return Integrator<Real,Method>::operator()(N,t,T);
+      return x;
     }
-
-  protected:
 };
 
 }
@@ -0,0 +1,82 @@
+#ifndef Utils_BoundedQueue_hpp
+#define Utils_BoundedQueue_hpp
+
+/** @file BoundedQueue.hpp
+  * @brief A thread safe FIFO queue with a fixed capacity.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace RUC {
+
+/** @class BoundedQueue
+  * @brief A FIFO queue for passing work between the stages of a pipeline.
+  * @author C.D. Clark III
+  *
+  * push() blocks while the queue is full, so a slow stage holds back the stages that feed it
+  * instead of letting work pile up in memory. Once the producer calls close(), pop() returns
+  * the remaining items and then false. close() can also be used to abort a pipeline, push()
+  * returns false on a closed queue.
+  */
+template<typename T>
+class BoundedQueue
+{
+  protected:
+    std::size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+
+  public:
+    explicit BoundedQueue( std::size_t _capacity )
+    :capacity( _capacity > 0 ? _capacity : 1 )
+    {}
+
+    /** Adds an item, waiting for room if the queue is full. Returns false if the queue has been closed. */
+    bool push( T item )
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      not_full.wait( lock, [&](){ return closed || items.size() < capacity; } );
+      if( closed )
+        return false;
+      items.push_back( std::move(item) );
+      lock.unlock();
+      not_empty.notify_one();
+      return true;
+    }
+
+    /** Removes the next item, waiting for one if the queue is empty. Returns false if the queue is closed and empty. */
+    bool pop( T &item )
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      not_empty.wait( lock, [&](){ return closed || !items.empty(); } );
+      if( items.empty() )
+        return false;
+      item = std::move( items.front() );
+      items.pop_front();
+      lock.unlock();
+      not_full.notify_one();
+      return true;
+    }
+
+    /** No more items will be pushed. Wakes up all waiting threads. */
+    void close()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+      }
+      not_empty.notify_all();
+      not_full.notify_all();
+    }
+};
+
+}
+
+#endif // include protector
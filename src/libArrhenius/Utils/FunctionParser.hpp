@@ -0,0 +1,213 @@
+#ifndef Utils_FunctionParser_hpp
+#define Utils_FunctionParser_hpp
+
+/** @file FunctionParser.hpp
+  * @brief Parses columns of numbers from a character buffer without copying it.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  */
+
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+
+namespace RUC {
+namespace detail {
+
+inline bool is_column_delimiter( char c ) { return c == ' ' || c == '\t' || c == ',' || c == '\r'; }
+
+#if !defined(__cpp_lib_to_chars) || __cpp_lib_to_chars < 201611L
+// strto* use the decimal point of the global locale, so a program that calls setlocale() (e.g. to "de_DE")
+// would fail to read "1.5". the *_l versions take the locale as an argument, so we always pass the C locale.
+#if defined(_WIN32)
+inline _locale_t c_locale() { static _locale_t loc = _create_locale( LC_NUMERIC, "C" ); return loc; }
+inline float       strto_c( char const *s, char **end, float )       { return _strtof_l( s, end, c_locale() ); }
+inline double      strto_c( char const *s, char **end, double )      { return _strtod_l( s, end, c_locale() ); }
+inline long double strto_c( char const *s, char **end, long double ) { return _strtold_l( s, end, c_locale() ); }
+#else
+inline locale_t c_locale() { static locale_t loc = newlocale( LC_NUMERIC_MASK, "C", (locale_t)0 ); return loc; }
+inline float       strto_c( char const *s, char **end, float )       { return strtof_l( s, end, c_locale() ); }
+inline double      strto_c( char const *s, char **end, double )      { return strtod_l( s, end, c_locale() ); }
+inline long double strto_c( char const *s, char **end, long double ) { return strtold_l( s, end, c_locale() ); }
+#endif
+#endif
+
+/** Parses the number in [b,e) into v. Returns false if the token isn't a number.
+  *
+  * Built-in floating point types use std::from_chars when the standard library provides it (C++17),
+  * which parses the token in place. Otherwise (e.g. when compiled as C++11 or C++14) the token is copied
+  * and parsed with strtod, in the C locale. Both are independent of the global locale.
+  */
+template<typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+parse_number( char const *b, char const *e, T &v )
+{
+  // from_chars doesn't accept a leading +, but lexical_cast did.
+  if( b != e && *b == '+' )
+    ++b;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  auto result = std::from_chars( b, e, v );
+  return result.ec == std::errc() && result.ptr == e;
+#else
+  // strto* need a null terminated string, and the token may be at the very end of a mapped file.
+  char small[64];
+  std::string large;
+  char const *s = small;
+  std::size_t len = e - b;
+  if( len < sizeof(small) )
+  {
+    std::memcpy( small, b, len );
+    small[len] = 0;
+  }
+  else
+  {
+    large.assign( b, e );
+    s = large.c_str();
+  }
+  char *end;
+  v = strto_c( s, &end, T() );
+  return len > 0 && end == s + len;
+#endif
+}
+
+/** Multiprecision types (i.e. cpp_dec_float) can be constructed directly from a string, which is much faster than going through a stream. */
+template<typename T>
+typename std::enable_if<!std::is_floating_point<T>::value && std::is_constructible<T,char const*>::value, bool>::type
+parse_number( char const *b, char const *e, T &v )
+{
+  // reuse the buffer so that parsing a token doesn't allocate.
+  static thread_local std::string buffer;
+  buffer.assign( b, e );
+  try {
+    v = T( buffer.c_str() );
+  } catch( std::exception & ) {
+    return false;
+  }
+  return true;
+}
+
+template<typename T>
+typename std::enable_if<!std::is_floating_point<T>::value && !std::is_constructible<T,char const*>::value, bool>::type
+parse_number( char const *b, char const *e, T &v )
+{
+  return boost::conversion::try_lexical_convert( b, e - b, v );
+}
+
+}
+
+/** @class FunctionParser
+  * @brief Parses a function stored as columns of numbers.
+  * @author C.D. Clark III
+  *
+  * Columns are separated by spaces, tabs or commas. Blank lines and lines that start with a #
+  * are skipped. The first _dimensions columns of each line are coordinates and the next
+  * _multiplicity columns are values, any extra columns are ignored.
+  *
+  * The parser works on a character buffer in place, so a file can be read in large chunks (or
+  * mapped) and parsed without creating a string for each line or token. The coordinates and
+  * values are appended to vectors, which grow geometrically.
+  */
+template < typename ArgType, typename ValType >
+class FunctionParser
+{
+  protected:
+    int multiplicity, dimensions;
+    std::size_t line = 0;
+    std::vector<ArgType> x;
+    std::vector<ValType> y;
+
+  public:
+    FunctionParser( int _multiplicity = 1, int _dimensions = 1 )
+    :multiplicity(_multiplicity), dimensions(_dimensions)
+    {}
+
+    /** Parse the lines in [begin,end).
+      *
+      * If last is false, the final line is assumed to be incomplete unless it ends with a newline,
+      * and it is not parsed. Returns a pointer to the first character that was not parsed, which
+      * should be passed in again with the rest of the data.
+      */
+    char const* parse( char const *begin, char const *end, bool last )
+    {
+      while( begin != end )
+      {
+        char const *eol = static_cast<char const*>( std::memchr( begin, '\n', end - begin ) );
+        if( !eol )
+        {
+          if( !last )
+            return begin;
+          eol = end;
+        }
+        parseLine( begin, eol );
+        begin = eol == end ? end : eol + 1;
+      }
+      return end;
+    }
+
+    /** The number of points parsed so far. */
+    std::size_t size() const { return dimensions > 0 ? x.size()/dimensions : y.size()/multiplicity; }
+
+    std::vector<ArgType>& coordinates() { return x; }
+    std::vector<ValType>& values() { return y; }
+
+  protected:
+    void parseLine( char const *b, char const *e )
+    {
+      ++line;
+      b = next( b, e );
+      if( b == e || *b == '#' )
+        return;
+
+      for(int j = 0; j < dimensions; j++)
+      {
+        x.push_back( ArgType() );
+        b = parseToken( b, e, x.back() );
+      }
+      for(int j = 0; j < multiplicity; j++)
+      {
+        y.push_back( ValType() );
+        b = parseToken( b, e, y.back() );
+      }
+    }
+
+    template<typename T>
+    char const* parseToken( char const *b, char const *e, T &v )
+    {
+      b = next( b, e );
+      if( b == e )
+        throw std::runtime_error("ERROR: Line "+std::to_string(line)+" has fewer than "+std::to_string(dimensions+multiplicity)+" columns.");
+      char const *te = b;
+      while( te != e && !detail::is_column_delimiter(*te) )
+        ++te;
+      if( !detail::parse_number( b, te, v ) )
+        throw std::runtime_error("ERROR: Could not parse '"+std::string(b,te)+"' on line "+std::to_string(line)+".");
+      return te;
+    }
+
+    static char const* next( char const *b, char const *e )
+    {
+      while( b != e && detail::is_column_delimiter(*b) )
+        ++b;
+      return b;
+    }
+};
+
+}
+
+#endif // include protector
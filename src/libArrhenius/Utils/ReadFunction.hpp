@@ -5,12 +5,81 @@
 #include <fstream>
 #include <string>
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include "Tokenizer.hpp"
+#include "FunctionParser.hpp"
 
 
 namespace RUC
 {
+  /** Reads a function from an input stream into vectors.
+   * The stream is read in large chunks and parsed in place (see FunctionParser), which is
+   * much faster than reading it line by line. The coordinates are appended to _x and the
+   * values to _y, _dimensions and _multiplicity at a time.
+   * */
+  template < typename ArgType, typename ValType >
+  void ReadFunction(std::istream &_in, std::vector<ArgType> &_x, std::vector<ValType> &_y, int _multiplicity = 1, int _dimensions = 1)
+  {
+    FunctionParser<ArgType,ValType> parser(_multiplicity, _dimensions);
+    parser.coordinates().swap(_x);
+    parser.values().swap(_y);
+
+    std::vector<char> buffer(1 << 20);
+    std::size_t kept = 0;
+    while( true )
+    {
+      _in.read( buffer.data() + kept, buffer.size() - kept );
+      std::size_t size = kept + _in.gcount();
+      bool last = !_in;
+      char const *rest = parser.parse( buffer.data(), buffer.data() + size, last );
+      if( last )
+        break;
+      // carry the incomplete line over to the next chunk. if it fills the whole buffer, the buffer is too small.
+      kept = buffer.data() + size - rest;
+      if( kept == buffer.size() )
+        buffer.resize( 2*buffer.size() );
+      else
+        std::memmove( buffer.data(), rest, kept );
+    }
+
+    parser.coordinates().swap(_x);
+    parser.values().swap(_y);
+  }
+
+  /** Reads a function from a file into vectors.
+   * The file is memory mapped and parsed in place, without copying it into a buffer.
+   * */
+  template < typename ArgType, typename ValType >
+  void ReadFunction(std::string const &_filename, std::vector<ArgType> &_x, std::vector<ValType> &_y, int _multiplicity = 1, int _dimensions = 1)
+  {
+    FunctionParser<ArgType,ValType> parser(_multiplicity, _dimensions);
+    parser.coordinates().swap(_x);
+    parser.values().swap(_y);
+
+    // empty files can't be mapped.
+    std::ifstream in(_filename.c_str());
+    if( !in )
+      throw std::runtime_error("ERROR: Could not open '"+_filename+"'.");
+    if( in.peek() != std::ifstream::traits_type::eof() )
+    {
+      in.close();
+      boost::interprocess::file_mapping mapping( _filename.c_str(), boost::interprocess::read_only );
+      boost::interprocess::mapped_region region( mapping, boost::interprocess::read_only );
+      region.advise( boost::interprocess::mapped_region::advice_sequential );
+      char const *data = static_cast<char const*>( region.get_address() );
+      parser.parse( data, data + region.get_size(), true );
+    }
+
+    parser.coordinates().swap(_x);
+    parser.values().swap(_y);
+  }
+
   /** Reads a function from an input stream.
    * Memory for _x and _y is allocated, and _n is set, based
    * on the number of data points found in the stream _in. _x and _y should NOT point
@@ -28,67 +97,11 @@ namespace RUC
   template < typename ArgType, typename ValType >
   void ReadFunction(std::istream &_in, ArgType  *&_x, ValType *&_y, int *&_n, int _multiplicity = 1, int _dimensions = 1)
   {
+    std::vector<ArgType> x;
+    std::vector<ValType> y;
+    ReadFunction(_in, x, y, _multiplicity, _dimensions);
 
-    ArgType *xbuffer1, *xbuffer2;
-    ValType *ybuffer1, *ybuffer2;
-
-    //////////////////////////////
-    //  READ IN DATA FROM FILE  //
-    //////////////////////////////
-
-    const int chunck = 1000;
-    int buffsize,buffsize_old;
-    int i,j;
-    int n;
-
-    std::string line;
-    
-
-    buffsize = chunck;
-
-    xbuffer1 = new ArgType[buffsize*_dimensions  ];
-    ybuffer1 = new ValType[buffsize*_multiplicity];
-
-    i = 0;
-    while( getline( _in, line ) )
-    {
-      // if line is blank, skip it
-      if( line == "" )
-        continue;
-      std::vector<std::string> columns = Tokenize(line);
-
-      // if first column starts with a #, this line is a comment
-      // and we should skip it.
-      if( columns.size() > 0 && columns[0].find('#') == 0 )
-        continue;
-
-      if(i == buffsize - 1)  // this "grows" the buffer
-      {
-        buffsize_old = buffsize;
-        buffsize = buffsize + chunck;
-
-        xbuffer2 = new ArgType[buffsize*_dimensions  ];
-        std::copy( xbuffer1, xbuffer1 + buffsize_old*_dimensions, xbuffer2);
-        delete[] xbuffer1;
-
-        ybuffer2 = new ValType[buffsize*_multiplicity];
-        std::copy( ybuffer1, ybuffer1 + buffsize_old*_multiplicity, ybuffer2);
-        delete[] ybuffer1;
-
-        xbuffer1 = xbuffer2;
-        ybuffer1 = ybuffer2;
-      }
-
-      for(j = 0; j < _dimensions; j++)
-        xbuffer1[i*_dimensions + j]   = lexical_cast<ArgType>(columns[j]);
-      for(j = 0; j < _multiplicity; j++)
-        ybuffer1[i*_multiplicity + j] = lexical_cast<ValType>(columns[j+_dimensions]);
-
-      i++;
-    }
-
-    n = i;
-
+    int n = _dimensions > 0 ? x.size()/_dimensions : y.size()/_multiplicity;
 
     /** \todo add actual multi-coordinate support */
 
@@ -96,17 +109,11 @@ namespace RUC
     _x = new ArgType[n * _dimensions  ];
     _y = new ValType[n * _multiplicity];
 
-    for(j = 0; j < n * _dimensions  ; j++)
-      _x[j] = xbuffer1[j];
-    for(j = 0; j < n * _multiplicity; j++)
-      _y[j] = ybuffer1[j];
-    for(j = 0; j < _dimensions; j++)
+    std::copy( x.begin(), x.end(), _x );
+    std::copy( y.begin(), y.end(), _y );
+    for(int j = 0; j < _dimensions; j++)
       _n[j] = n;
-
-    delete[] xbuffer1;
-    delete[] ybuffer1;
-
-    }
+  }
 
   /** specialized version of ReadFunction that takes an integer for _n (rather than an integer array)
    * and reads in a 1D function
@@ -0,0 +1,223 @@
+#! /usr/bin/env python3
+
+'''Compare libArrhenius benchmark results against a baseline.
+
+Usage: compare-benchmarks.py [options] BASELINE.json CURRENT.json [CURRENT.json ...]
+
+Both files are written by libArrhenius-benchmarks. Several current files can be
+given, each run of the sweep in each file (see its --runs option) is one run.
+
+For each benchmark in both sets, the change in throughput is estimated from the
+mean time per call, and a confidence interval for it is computed with Welch's t
+interval. A benchmark only counts as a regression if the whole interval is beyond
+the threshold, so that noise does not fail the comparison. The intervals are widened
+for the number of benchmarks compared (Bonferroni), so the confidence level applies
+to the whole comparison, not to each benchmark. Exits with status 1 if any benchmark
+regressed.
+
+The timings drift between runs by much more than the repetitions within a run
+vary, so when both sides have at least two runs, each run contributes one sample
+(its fastest repetition). Otherwise the repetitions are used and the intervals
+will be too narrow.
+
+Timings are only comparable between runs on the same machine with the same number
+of threads. Each file records both in its context, and the comparison is refused
+(exit status 2) if they differ from the baseline, unless --ignore-context is given.
+'''
+
+import argparse
+import json
+import math
+import re
+import sys
+
+
+def betacf(a, b, x):
+  '''Continued fraction for the incomplete beta function (Numerical Recipes).'''
+  tiny = 1e-300
+  qab, qap, qam = a + b, a + 1, a - 1
+  c, d = 1.0, 1 - qab * x / qap
+  d = 1 / (d if abs(d) > tiny else tiny)
+  h = d
+  for m in range(1, 300):
+    m2 = 2 * m
+    aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+    d = 1 + aa * d
+    d = 1 / (d if abs(d) > tiny else tiny)
+    c = 1 + aa / c
+    c = c if abs(c) > tiny else tiny
+    h *= d * c
+    aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+    d = 1 + aa * d
+    d = 1 / (d if abs(d) > tiny else tiny)
+    c = 1 + aa / c
+    c = c if abs(c) > tiny else tiny
+    delta = d * c
+    h *= delta
+    if abs(delta - 1) < 1e-12:
+      break
+  return h
+
+
+def betai(a, b, x):
+  '''Regularized incomplete beta function.'''
+  if x <= 0:
+    return 0.0
+  if x >= 1:
+    return 1.0
+  lbeta = math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b)
+  front = math.exp(lbeta + a * math.log(x) + b * math.log(1 - x))
+  if x < (a + 1) / (a + b + 2):
+    return front * betacf(a, b, x) / a
+  return 1 - front * betacf(b, a, 1 - x) / b
+
+
+def t_critical(confidence, df):
+  '''Two-sided critical value of Student's t distribution.'''
+  alpha = 1 - confidence
+  lo, hi = 0.0, 1e3
+  for _ in range(200):
+    t = (lo + hi) / 2
+    # two-sided tail probability of |T| > t
+    p = betai(df / 2, 0.5, df / (df + t * t))
+    if p > alpha:
+      lo = t
+    else:
+      hi = t
+  return (lo + hi) / 2
+
+
+def mean_var(x):
+  m = sum(x) / len(x)
+  v = sum((xi - m)**2 for xi in x) / (len(x) - 1) if len(x) > 1 else 0.0
+  return m, v
+
+
+# the context fields that must match for the timings to be comparable.
+CONTEXT_KEYS = ('machine', 'max_threads')
+
+
+def check_context(baseline, currents):
+  '''Returns a message for each context field that differs from the baseline (or is missing).'''
+  with open(baseline) as f:
+    base = json.load(f).get('context', {})
+  problems = []
+  for filename in currents:
+    with open(filename) as f:
+      context = json.load(f).get('context', {})
+    for key in CONTEXT_KEYS:
+      if key not in base or key not in context or base[key] != context[key]:
+        problems.append('%s: %s has %r, the baseline has %r.'
+                        % (key, filename, context.get(key, '(not recorded)'), base.get(key, '(not recorded)')))
+  return problems
+
+
+def load(filenames, pattern):
+  '''Returns {name: [[times of a run], ...]} over all of the files.'''
+  benchmarks = {}
+  for i, filename in enumerate(filenames):
+    with open(filename) as f:
+      data = json.load(f)
+    for b in data['benchmarks']:
+      if not pattern.search(b['name']):
+        continue
+      benchmarks.setdefault(b['name'], {}).setdefault((i, b.get('run', 0)), []).extend(b['times'])
+  return {name: list(runs.values()) for name, runs in benchmarks.items()}
+
+
+def samples(base, current):
+  '''Picks the samples to compare, see the module documentation.'''
+  if len(base) > 1 and len(current) > 1:
+    return [min(r) for r in base], [min(r) for r in current]
+  return sum(base, []), sum(current, [])
+
+
+def compare(base, current, confidence):
+  '''Returns the estimated throughput drop and its confidence interval, as fractions.
+
+  A drop of 0.1 means the current build does 10% less work per second than the baseline.
+  '''
+  mb, vb = mean_var(base)
+  mc, vc = mean_var(current)
+  nb, nc = len(base), len(current)
+  se2 = vb / nb + vc / nc
+  diff = mc - mb
+  if se2 > 0:
+    # Welch-Satterthwaite degrees of freedom
+    df = se2**2 / ((vb / nb)**2 / max(nb - 1, 1) + (vc / nc)**2 / max(nc - 1, 1))
+    half = t_critical(confidence, max(df, 1)) * math.sqrt(se2)
+  else:
+    half = 0.0
+
+  def drop(d):
+    # throughput is inversely proportional to the time, drop = 1 - mb/(mb + d)
+    return 1 - mb / (mb + d) if mb + d > 0 else -math.inf
+
+  return drop(diff), drop(diff - half), drop(diff + half)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('baseline', help='baseline JSON file.')
+  parser.add_argument('current', nargs='+', help='benchmark JSON files for the current build.')
+  parser.add_argument('--threshold', type=float, default=0.10,
+                      help='fail if throughput dropped by more than this fraction (default 0.10).')
+  parser.add_argument('--confidence', type=float, default=0.95,
+                      help='confidence that none of the reported changes are noise (default 0.95).')
+  parser.add_argument('--filter', default='.*', help='only compare the benchmarks whose names match this regex.')
+  parser.add_argument('--verbose', action='store_true', help='print every benchmark, not just the changed ones.')
+  parser.add_argument('--ignore-context', action='store_true',
+                      help='compare even if the machine or thread count differs from the baseline.')
+  args = parser.parse_args()
+
+  problems = check_context(args.baseline, args.current)
+  if problems:
+    level = 'WARNING' if args.ignore_context else 'ERROR'
+    print('%s: the results were not recorded on the same machine and thread count as the baseline,' % level)
+    print('%s: so differences in the timings are not regressions.' % level)
+    for problem in problems:
+      print('%s:   %s' % (level, problem))
+    if not args.ignore_context:
+      print('ERROR: record a baseline on this machine (update-benchmark-baseline), or pass --ignore-context.')
+      return 2
+
+  pattern = re.compile(args.filter)
+  baseline = load([args.baseline], pattern)
+  current = load(args.current, pattern)
+
+  regressions, improvements, missing = [], [], []
+  per_run = True
+  confidence = 1 - (1 - args.confidence) / max(len(set(baseline) & set(current)), 1)
+  print('%-80s %9s %21s' % ('benchmark', 'change', '%.4g%% interval' % (100 * confidence)))
+  for name in sorted(baseline):
+    if name not in current:
+      missing.append(name)
+      continue
+    per_run = per_run and len(baseline[name]) > 1 and len(current[name]) > 1
+    d, lo, hi = compare(*samples(baseline[name], current[name]), confidence=confidence)
+    status = ''
+    if lo > args.threshold:
+      status = 'REGRESSION'
+      regressions.append(name)
+    elif hi < -args.threshold:
+      status = 'improvement'
+      improvements.append(name)
+    if status or args.verbose:
+      # report the change in throughput, a positive change is faster
+      print('%-80s %+8.1f%% [%+8.1f%%, %+8.1f%%] %s' % (name, -100 * d, -100 * hi, -100 * lo, status))
+
+  for name in missing:
+    print('WARNING: %s is in the baseline but was not run.' % name)
+  if not per_run:
+    print('WARNING: some benchmarks have a single run, their intervals do not include the drift between runs.')
+  new = sorted(set(current) - set(baseline))
+  if new:
+    print('%d benchmarks are not in the baseline.' % len(new))
+
+  print('compared %d benchmarks: %d regressions, %d improvements (threshold %g%%).'
+        % (len(baseline) - len(missing), len(regressions), len(improvements), 100 * args.threshold))
+  return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,504 @@
+/** @file libArrhenius-benchmarks.cpp
+  * @brief Times the integrators, threshold calculator and fitters over a sweep of types, methods, sizes and thread counts.
+  * @author C.D. Clark III
+  * @date 10/17/26
+  *
+  * The results are written as JSON so that they can be compared between builds.
+  *
+  * Usage: libArrhenius-benchmarks [options]
+  *
+  *   --output FILE       write the JSON to FILE instead of stdout.
+  *   --filter REGEX      only run the benchmarks whose names match REGEX.
+  *   --min-N N           smallest profile size (default 10).
+  *   --max-N N           largest profile size (default 10000000).
+  *   --threads LIST      comma separated thread counts (default 1 and the maximum).
+  *   --repetitions R     number of timed repetitions of each benchmark (default 5).
+  *   --runs K            run the whole sweep K times (default 1). Each benchmark is reported once per run,
+  *                       which captures the drift between runs that the repetitions within a run miss.
+  *   --min-time S        each repetition runs for at least S seconds (default 0.05).
+  *   --max-time S        stop increasing N once a single call takes more than S seconds (default 1).
+  *   --list              print the names of the benchmarks instead of running them.
+  *
+  * Benchmark names look like integral/ArrheniusIntegral/Trapezoid/double/threads=1/N=1000.
+  */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+
+#include <libArrhenius/version.h>
+#include <libArrhenius/Arrhenius.hpp>
+
+using namespace libArrhenius;
+namespace logging = boost::log;
+using boost::multiprecision::cpp_dec_float_50;
+using boost::multiprecision::cpp_dec_float_100;
+
+template<typename T> struct Name {};
+template<> struct Name<float> { static std::string get() { return "float"; } };
+template<> struct Name<double> { static std::string get() { return "double"; } };
+template<> struct Name<long double> { static std::string get() { return "long double"; } };
+template<> struct Name<cpp_dec_float_50> { static std::string get() { return "cpp_dec_float_50"; } };
+template<> struct Name<cpp_dec_float_100> { static std::string get() { return "cpp_dec_float_100"; } };
+template<> struct Name<Trapezoid> { static std::string get() { return "Trapezoid"; } };
+template<> struct Name<ExponentialIntegral> { static std::string get() { return "ExponentialIntegral"; } };
+template<> struct Name<MixedPrecision> { static std::string get() { return "MixedPrecision"; } };
+template<> struct Name<MinimizeLogAVarianceAndScalingFactors> { static std::string get() { return "MinimizeLogAVarianceAndScalingFactors"; } };
+template<> struct Name<EffectiveExposuresLinearRegression> { static std::string get() { return "EffectiveExposuresLinearRegression"; } };
+
+const double A = 3.1e99;
+const double Ea = 6.28e5;
+
+// keeps the compiler from optimizing away the work being timed.
+volatile double sink;
+template<typename Real>
+void consume( Real const &v ) { sink = static_cast<double>(v); }
+
+void set_threads( int threads )
+{
+#ifdef _OPENMP
+  omp_set_num_threads( threads );
+#endif
+}
+
+int max_threads()
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+struct Options
+{
+  std::string output = "-";
+  std::string filter = ".*";
+  std::size_t min_N = 10;
+  std::size_t max_N = 10000000;
+  std::vector<int> threads;
+  int repetitions = 5;
+  int runs = 1;
+  double min_time = 0.05;
+  double max_time = 1;
+  bool list = false;
+};
+
+struct Result
+{
+  std::string name;
+  std::string group;
+  std::string integrator;
+  std::string method;
+  std::string real;
+  std::size_t N = 0;
+  std::size_t profiles = 1;
+  int threads = 1;
+  int run = 0;
+  std::size_t iterations = 0;
+  std::vector<double> times; // seconds per call, one for each repetition
+};
+
+class Runner
+{
+  protected:
+    Options opts;
+    std::regex filter;
+    std::vector<Result> results;
+    int current_run = 0;
+
+  public:
+    Runner( Options const &opts_ )
+    :opts(opts_), filter(opts_.filter)
+    {}
+
+    Options const& options() const { return opts; }
+    void setRun( int run ) { current_run = run; }
+
+    /** Times f and records the result.
+      *
+      * f is called enough times per repetition to run for at least min_time. Returns false if a
+      * single call took longer than max_time, which tells the caller not to try larger problems.
+      */
+    template<typename F>
+    bool run( Result r, F f )
+    {
+      if( !std::regex_search( r.name, filter ) )
+        return true;
+      if( opts.list )
+      {
+        std::cout << r.name << "\n";
+        return true;
+      }
+
+      r.run = current_run;
+      set_threads( r.threads );
+      double single = time( 1, f ); // also warms up
+      r.iterations = static_cast<std::size_t>( std::max( 1.0, std::ceil( opts.min_time/std::max(single,1e-9) ) ) );
+      for( int i = 0; i < opts.repetitions; ++i )
+        r.times.push_back( time( r.iterations, f )/r.iterations );
+
+      double best = *std::min_element( r.times.begin(), r.times.end() );
+      std::cerr << r.name << ": " << best << " s" << std::endl;
+      results.push_back( r );
+      return single < opts.max_time;
+    }
+
+    void write( std::ostream &out ) const
+    {
+      std::time_t now = std::time(nullptr);
+      char date[64];
+      std::strftime( date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now) );
+
+      out << "{\n";
+      out << "  \"context\": {\n";
+      out << "    \"library_version\": \"" << libArrhenius_VERSION_FULL << "\",\n";
+      out << "    \"compiler\": \"" << __VERSION__ << "\",\n";
+      out << "    \"date\": \"" << date << "\",\n";
+      out << "    \"machine\": \"" << json_escape( ParallelThresholdCache::machineId() ) << "\",\n";
+      out << "    \"max_threads\": " << max_threads() << ",\n";
+      out << "    \"repetitions\": " << opts.repetitions << ",\n";
+      out << "    \"runs\": " << opts.runs << "\n";
+      out << "  },\n";
+      out << "  \"benchmarks\": [";
+      out.precision(9);
+      for( std::size_t i = 0; i < results.size(); ++i )
+      {
+        Result const &r = results[i];
+        double mean = std::accumulate( r.times.begin(), r.times.end(), 0.0 )/r.times.size();
+        double var = 0;
+        for( auto t : r.times )
+          var += (t - mean)*(t - mean);
+        double stddev = r.times.size() > 1 ? std::sqrt( var/(r.times.size()-1) ) : 0;
+
+        out << (i ? ",\n" : "\n");
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"group\": \"" << r.group << "\""
+            << ", \"integrator\": \"" << r.integrator << "\""
+            << ", \"method\": \"" << r.method << "\""
+            << ", \"real\": \"" << r.real << "\""
+            << ", \"N\": " << r.N
+            << ", \"profiles\": " << r.profiles
+            << ", \"threads\": " << r.threads
+            << ", \"run\": " << r.run
+            << ", \"iterations\": " << r.iterations
+            << ", \"times\": [";
+        for( std::size_t j = 0; j < r.times.size(); ++j )
+          out << (j ? ", " : "") << r.times[j];
+        out << "], \"mean\": " << mean
+            << ", \"stddev\": " << stddev
+            << ", \"min\": " << *std::min_element( r.times.begin(), r.times.end() )
+            << ", \"samples_per_second\": " << r.N*r.profiles/mean
+            << "}";
+      }
+      out << "\n  ]\n}\n";
+    }
+
+  protected:
+    // the CPU model is read from /proc/cpuinfo, so it could contain anything.
+    static std::string json_escape( std::string const &in )
+    {
+      std::string escaped;
+      for( char c : in )
+      {
+        if( c == '"' || c == '\\' )
+          escaped += '\\';
+        escaped += c;
+      }
+      return escaped;
+    }
+
+    template<typename F>
+    static double time( std::size_t iterations, F &f )
+    {
+      auto start = std::chrono::steady_clock::now();
+      for( std::size_t i = 0; i < iterations; ++i )
+        f();
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      return elapsed.count();
+    }
+};
+
+// a 10 s gaussian pulse sampled N times.
+template<typename Real>
+void make_profile( std::size_t N, std::vector<Real> &t, std::vector<Real> &T )
+{
+  t.resize(N);
+  T.resize(N);
+  for( std::size_t i = 0; i < N; ++i )
+  {
+    double ti = 10.*i/N;
+    t[i] = ti;
+    T[i] = 310 + 20*std::exp( -std::pow( (ti-5)/2, 2 ) );
+  }
+}
+
+std::string name( std::string group, std::string integrator, std::string method, std::string real, int threads, std::size_t N )
+{
+  std::ostringstream ss;
+  ss << group << "/" << integrator << "/" << method << "/" << real << "/threads=" << threads << "/N=" << N;
+  return ss.str();
+}
+
+template<typename Integrator, typename Real, typename Method>
+void integral_benchmarks( Runner &runner, std::string integrator_name, Integrator const &integrate )
+{
+  for( int threads : runner.options().threads )
+  {
+    for( std::size_t N = runner.options().min_N; N <= runner.options().max_N; N *= 10 )
+    {
+      std::vector<Real> t, T;
+      make_profile( N, t, T );
+
+      Result r;
+      r.group = "integral";
+      r.integrator = integrator_name;
+      r.method = Name<Method>::get();
+      r.real = Name<Real>::get();
+      r.N = N;
+      r.threads = threads;
+      r.name = name( r.group, r.integrator, r.method, r.real, threads, N );
+      if( !runner.run( r, [&](){ consume( integrate( N, t.data(), T.data() ) ); } ) )
+        break;
+    }
+  }
+}
+
+template<typename Real, typename Method>
+void integral_benchmarks( Runner &runner )
+{
+  integral_benchmarks<ArrheniusIntegral<Real,Method>,Real,Method>( runner, "ArrheniusIntegral", ArrheniusIntegral<Real,Method>(A,Ea) );
+}
+
+template<typename Real, typename Method>
+void modified_integral_benchmarks( Runner &runner )
+{
+  integral_benchmarks<ModifiedArrheniusIntegral<Real,Method>,Real,Method>( runner, "ModifiedArrheniusIntegral", ModifiedArrheniusIntegral<Real,Method>(A,Ea,0.5) );
+}
+
+template<typename Real>
+void threshold_benchmarks( Runner &runner )
+{
+  ThresholdCalculator<ArrheniusIntegral<Real,Trapezoid>> calc(A,Ea);
+  for( int threads : runner.options().threads )
+  {
+    // a single profile
+    for( std::size_t N = runner.options().min_N; N <= runner.options().max_N; N *= 10 )
+    {
+      std::vector<Real> t, T;
+      make_profile( N, t, T );
+
+      Result r;
+      r.group = "threshold";
+      r.integrator = "ArrheniusIntegral";
+      r.method = Name<Trapezoid>::get();
+      r.real = Name<Real>::get();
+      r.N = N;
+      r.threads = threads;
+      r.name = name( r.group, r.integrator, r.method, r.real, threads, N );
+      if( !runner.run( r, [&](){ consume( calc( N, t.data(), T.data() ) ); } ) )
+        break;
+    }
+
+    // many profiles at once
+    std::size_t M = 64, N = 1000;
+    ProfileSet<Real> profiles;
+    for( std::size_t j = 0; j < M; ++j )
+    {
+      std::vector<Real> t, T;
+      make_profile( N + j, t, T );
+      profiles.addProfile( t.size(), t.data(), T.data() );
+    }
+    Result r;
+    r.group = "threshold-batch";
+    r.integrator = "ArrheniusIntegral";
+    r.method = Name<Trapezoid>::get();
+    r.real = Name<Real>::get();
+    r.N = N;
+    r.profiles = M;
+    r.threads = threads;
+    r.name = name( r.group, r.integrator, r.method, r.real, threads, N );
+    runner.run( r, [&](){ consume( calc( profiles )[0] ); } );
+  }
+}
+
+// fit the coefficients to the threshold profiles of a set of square pulses, like the fitting unit tests.
+template<typename Real, typename FitMethod>
+void fit_benchmarks( Runner &runner )
+{
+  std::vector<double> taus = { 0.001, 0.01, 0.1, 1.0, 10.0 };
+  std::size_t N = 80;
+  std::vector<std::vector<Real>> ts, Ts;
+  ThresholdCalculator<ArrheniusIntegral<Real,Trapezoid>> calc(A,Ea);
+  for( auto tau : taus )
+  {
+    std::vector<Real> t(N), T(N);
+    for( std::size_t i = 0; i < N; ++i )
+    {
+      t[i] = tau/20*i;
+      T[i] = 310;
+      if( t[i] > tau/2 )
+        T[i] = 10 + 310;
+      if( t[i] > tau + tau/2 )
+        T[i] = 310;
+    }
+    Real threshold = calc( N, t.data(), T.data() );
+    for( std::size_t i = 0; i < N; ++i )
+      T[i] = threshold*(T[i] - T[0]) + T[0];
+    ts.push_back(t);
+    Ts.push_back(T);
+  }
+
+  for( int threads : runner.options().threads )
+  {
+    Result r;
+    r.group = "fit";
+    r.integrator = "ArrheniusFit";
+    r.method = Name<FitMethod>::get();
+    r.real = Name<Real>::get();
+    r.N = N;
+    r.profiles = taus.size();
+    r.threads = threads;
+    r.name = name( r.group, r.integrator, r.method, r.real, threads, N );
+    runner.run( r, [&](){
+        ArrheniusFit<Real,FitMethod> fit;
+        for( std::size_t j = 0; j < ts.size(); ++j )
+          fit.addProfile( N, ts[j].data(), Ts[j].data() );
+        consume( fit.exec().Ea.get() ); } );
+  }
+}
+
+template<typename Real>
+void sweep( Runner &runner )
+{
+  integral_benchmarks<Real,Trapezoid>( runner );
+  integral_benchmarks<Real,ExponentialIntegral>( runner );
+  modified_integral_benchmarks<Real,Trapezoid>( runner );
+  threshold_benchmarks<Real>( runner );
+}
+
+template<typename Real>
+void multiprecision_sweep( Runner &runner )
+{
+  sweep<Real>( runner );
+  integral_benchmarks<Real,MixedPrecision>( runner );
+  modified_integral_benchmarks<Real,MixedPrecision>( runner );
+}
+
+int main( int argc, char *argv[] )
+{
+  Options opts;
+  for( int i = 1; i < argc; ++i )
+  {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if( i + 1 >= argc )
+      {
+        std::cerr << "ERROR: " << arg << " requires a value." << std::endl;
+        std::exit(1);
+      }
+      return argv[++i]; };
+
+    if( arg == "--output" )
+      opts.output = value();
+    else if( arg == "--filter" )
+      opts.filter = value();
+    else if( arg == "--min-N" )
+      opts.min_N = std::stoul( value() );
+    else if( arg == "--max-N" )
+      opts.max_N = std::stoul( value() );
+    else if( arg == "--repetitions" )
+      opts.repetitions = std::stoi( value() );
+    else if( arg == "--runs" )
+      opts.runs = std::stoi( value() );
+    else if( arg == "--min-time" )
+      opts.min_time = std::stod( value() );
+    else if( arg == "--max-time" )
+      opts.max_time = std::stod( value() );
+    else if( arg == "--threads" )
+    {
+      std::stringstream ss( value() );
+      std::string item;
+      while( std::getline( ss, item, ',' ) )
+        opts.threads.push_back( std::stoi(item) );
+    }
+    else if( arg == "--list" )
+      opts.list = true;
+    else
+    {
+      std::cerr << "ERROR: unknown option '" << arg << "'. See the top of libArrhenius-benchmarks.cpp for usage." << std::endl;
+      return 1;
+    }
+  }
+  if( opts.threads.empty() )
+  {
+    opts.threads.push_back(1);
+    if( max_threads() > 1 )
+      opts.threads.push_back( max_threads() );
+  }
+  if( opts.repetitions < 1 || opts.runs < 1 || opts.min_N < 1 )
+  {
+    std::cerr << "ERROR: --repetitions, --runs and --min-N must be at least 1." << std::endl;
+    return 1;
+  }
+
+  // the fitters log their progress, which would swamp the timings.
+  logging::core::get()->set_filter( logging::trivial::severity >= logging::trivial::error );
+
+  Runner runner( opts );
+
+  for( int run = 0; run < (opts.list ? 1 : opts.runs); ++run )
+  {
+    runner.setRun( run );
+
+    sweep<float>( runner );
+    sweep<double>( runner );
+    sweep<long double>( runner );
+    multiprecision_sweep<cpp_dec_float_50>( runner );
+    multiprecision_sweep<cpp_dec_float_100>( runner );
+
+    fit_benchmarks<double,MinimizeLogAVarianceAndScalingFactors>( runner );
+    fit_benchmarks<double,EffectiveExposuresLinearRegression>( runner );
+    fit_benchmarks<cpp_dec_float_100,MinimizeLogAVarianceAndScalingFactors>( runner );
+    fit_benchmarks<cpp_dec_float_100,EffectiveExposuresLinearRegression>( runner );
+  }
+
+  if( opts.list )
+    return 0;
+
+  if( opts.output == "-" )
+  {
+    runner.write( std::cout );
+  }
+  else
+  {
+    std::ofstream out( opts.output );
+    runner.write( out );
+    if( !out )
+    {
+      std::cerr << "ERROR: Could not write '" << opts.output << "'." << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
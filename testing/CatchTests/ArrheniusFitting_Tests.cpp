@@ -13,6 +13,10 @@
 #include <boost/multiprecision/cpp_dec_float.hpp>
 using namespace boost::multiprecision;
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace libArrhenius;
 
 typedef cpp_dec_float_100 DataType;
@@ -299,3 +303,135 @@ TEST_CASE( "ArrheniusFitterInterface Usage", "[usage]" ) {
 
 }
 
+TEST_CASE( "ArrheniusFitter Thread Independence", "[usage]" ) {
+
+  // enough samples for the fit to evaluate its cost function in parallel.
+  std::vector<double> taus = { 0.001, 0.01, 0.1, 1.0, 10.0 };
+  std::vector<std::vector<double>> ts,Ts;
+  size_t N = 400;
+
+  ThresholdCalculator< ArrheniusIntegral<double> > calc(3.1e99,6.28e5);
+  for( auto tau : taus )
+  {
+    std::vector<double> t(N), T(N);
+    for( size_t i = 0; i < N; i++ )
+    {
+      t[i] = tau/100*i;
+      T[i] = 310;
+      if( t[i] > tau/2 )
+        T[i] = 10 + 310;
+      if( t[i] > tau + tau/2 )
+        T[i] = 310;
+    }
+    auto Threshold = calc(N,t.data(),T.data());
+    for( size_t i = 0; i < N; i++ )
+      T[i] = Threshold*(T[i] - T[0]) + T[0];
+    ts.push_back(t);
+    Ts.push_back(T);
+  }
+
+  auto run = [&](int threads){
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#endif
+    ArrheniusFit< double, MinimizeLogAVarianceAndScalingFactors > fit;
+    for( size_t j = 0; j < ts.size(); ++j )
+      fit.addProfile( N, ts[j].data(), Ts[j].data() );
+    return fit.exec();
+  };
+
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+#endif
+  auto serial = run(1);
+  auto parallel = run(4);
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+
+  // the results must be identical, not just close.
+  CHECK( serial.Ea.get() == parallel.Ea.get() );
+  CHECK( serial.A.get() == parallel.A.get() );
+  CHECK( serial.Ea.get() == Approx(6.28e5).epsilon(0.1) );
+
+}
+
+TEST_CASE( "ArrheniusFitter Indistinguishable Profiles", "[usage]" ) {
+
+  // the cost is zero for every Ea if the profiles are the same (or if there is only one),
+  // so there is no minimum to find. the fit used to hang here.
+  size_t N = 80;
+  std::vector<double> t(N), T(N);
+  for( size_t i = 0; i < N; i++ )
+  {
+    t[i] = 0.1/20*i;
+    T[i] = 310;
+    if( t[i] > 0.05 )
+      T[i] = 10 + 310;
+    if( t[i] > 0.15 )
+      T[i] = 310;
+  }
+
+  ArrheniusFit< double, MinimizeLogAVarianceAndScalingFactors > fit;
+  fit.addProfile( N, t.data(), T.data() );
+  CHECK_THROWS_AS( fit.exec(), std::runtime_error );
+  fit.addProfile( N, t.data(), T.data() );
+  CHECK_THROWS_AS( fit.exec(), std::runtime_error );
+
+}
+
+TEST_CASE( "ArrheniusFitter Narrow Ea Range", "[usage]" ) {
+
+  // the upper bound on Ea for these profiles (in double) is 3.2768e6, so a lower bound
+  // close to it leaves less than two steps of the scan grid.
+  std::vector<double> taus = { 0.001, 0.01, 0.1, 1.0, 10.0 };
+  std::vector<std::vector<double>> ts,Ts;
+  size_t N = 400;
+
+  ThresholdCalculator< ArrheniusIntegral<double> > calc(3.1e99,6.28e5);
+  for( auto tau : taus )
+  {
+    std::vector<double> t(N), T(N);
+    for( size_t i = 0; i < N; i++ )
+    {
+      t[i] = tau/100*i;
+      T[i] = 310;
+      if( t[i] > tau/2 )
+        T[i] = 10 + 310;
+      if( t[i] > tau + tau/2 )
+        T[i] = 310;
+    }
+    auto Threshold = calc(N,t.data(),T.data());
+    for( size_t i = 0; i < N; i++ )
+      T[i] = Threshold*(T[i] - T[0]) + T[0];
+    ts.push_back(t);
+    Ts.push_back(T);
+  }
+
+  ArrheniusFit< double, MinimizeLogAVarianceAndScalingFactors > fit;
+  for( size_t j = 0; j < ts.size(); ++j )
+    fit.addProfile( N, ts[j].data(), Ts[j].data() );
+
+  SECTION("lower bound close to the upper bound")
+  {
+    fit.setMinEa(1.7e6);
+    auto ret = fit.exec();
+    CHECK( ret.Ea.get() == Approx(1.7e6) );
+  }
+
+  SECTION("lower bound above the upper bound")
+  {
+    fit.setMinEa(4e6);
+    CHECK_THROWS_AS( fit.exec(), std::runtime_error );
+  }
+
+  SECTION("upper bound with the minimum inside the scan")
+  {
+    // the bracket must come from the scan grid, not from the upper bound on Ea.
+    fit.setMaxEa(1.5e6);
+    auto ret = fit.exec();
+    CHECK( ret.Ea.get() <= 1.5e6 );
+    CHECK( ret.Ea.get() == Approx(6.28e5).epsilon(0.1) );
+  }
+
+}
@@ -207,3 +207,398 @@ TEST_CASE("ArrheniusIntegral With Boost.Multiprecision", "[integral]")
 
   CHECK(Omega != std::numeric_limits<cpp_dec_float_100>::infinity());
 }
+
+TEST_CASE("ArrheniusIntegral Vectorized Kernel", "[integral]")
+{
+  SECTION("exp")
+  {
+    for (double x = -800; x < 800; x += 0.37) {
+      double e = std::exp(x);
+      CHECK(Integration::detail::VectorizedExp<double>::eval(x) == Approx(e).epsilon(1e-14).margin(1e-320));
+    }
+    for (float x = -110; x < 100; x += 0.37f) {
+      float e = std::exp(x);
+      CHECK(Integration::detail::VectorizedExp<float>::eval(x) == Approx(e).epsilon(1e-6).margin(1e-44));
+    }
+    CHECK(std::isnan(Integration::detail::VectorizedExp<double>::eval(std::numeric_limits<double>::quiet_NaN())));
+  }
+
+  SECTION("E2")
+  {
+    // below 2 the kernel falls back to boost, so cover both sides of it.
+    std::vector<double> x, e, g;
+    std::vector<float>  xf, ef, gf;
+    for (double xi = 0.01; xi < 5000; xi *= 1.07) {
+      x.push_back(xi);
+      xf.push_back(static_cast<float>(xi));
+    }
+    e.resize(x.size());
+    g.resize(x.size());
+    ef.resize(x.size());
+    gf.resize(x.size());
+    Integration::detail::expint2_product(x.size(), 1.0, x.data(), e.data(), g.data());
+    Integration::detail::expint2_product(xf.size(), 1.0f, xf.data(), ef.data(), gf.data());
+    for (size_t i = 0; i < x.size(); i++) {
+      CHECK(e[i] == Approx(std::exp(-x[i])).epsilon(1e-14).margin(1e-320));
+      CHECK(e[i] * g[i] == Approx(boost::math::expint(2, x[i])).epsilon(1e-14).margin(1e-320));
+      if (x[i] < 700) CHECK(gf[i] == Approx(std::exp(x[i]) * boost::math::expint(2, x[i])).epsilon(1e-6));
+    }
+  }
+
+  SECTION("Trapezoid")
+  {
+    // a smooth pulse that is long enough to span several blocks of the kernel.
+    size_t                   N = 1000;
+    std::vector<double>      t(N), T(N);
+    std::vector<float>       tf(N), Tf(N);
+    std::vector<long double> tl(N), Tl(N);
+    for (size_t i = 0; i < N; i++) {
+      t[i] = 0.01 * i;
+      T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+      tf[i] = t[i];
+      Tf[i] = T[i];
+      tl[i] = t[i];
+      Tl[i] = T[i];
+    }
+
+    ArrheniusIntegral<double>      Arr(3.1e99, 6.28e5);
+    ArrheniusIntegral<float>       Arrf(1, 6.28e5);
+    ArrheniusIntegral<long double> Arrl(3.1e99, 6.28e5);
+    double                         Omega  = Arr(N, t.data(), T.data());
+    long double                    Omegal = Arrl(N, tl.data(), Tl.data());
+    CHECK(Omega == Approx(static_cast<double>(Omegal)).epsilon(1e-12));
+
+    // A = 3.1e99 doesn't fit in a float, so scale after integrating
+    Arrl.setA(1);
+    Arrl.setEa(2e5);
+    Arrf.setEa(2e5);
+    Omegal = Arrl(N, tl.data(), Tl.data());
+    float Omegaf = Arrf(N, tf.data(), Tf.data());
+    CHECK(Omegaf == Approx(static_cast<double>(Omegal)).epsilon(1e-5));
+  }
+
+  SECTION("Exponential Integral")
+  {
+    // large steps, so that most intervals use the exact difference rather than the rectangle.
+    size_t                   N = 1000;
+    std::vector<double>      t(N), T(N);
+    std::vector<float>       tf(N), Tf(N);
+    std::vector<long double> tl(N), Tl(N);
+    for (size_t i = 0; i < N; i++) {
+      t[i] = 0.01 * i;
+      T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2)) + 5 * (i % 2);
+      tf[i] = t[i];
+      Tf[i] = T[i];
+      tl[i] = t[i];
+      Tl[i] = T[i];
+    }
+
+    ArrheniusIntegral<double, ExponentialIntegral>      Arr(3.1e99, 6.28e5);
+    ArrheniusIntegral<float, ExponentialIntegral>       Arrf(1, 2e5);
+    ArrheniusIntegral<long double, ExponentialIntegral> Arrl(3.1e99, 6.28e5);
+    double      Omega  = Arr(N, t.data(), T.data());
+    long double Omegal = Arrl(N, tl.data(), Tl.data());
+    CHECK(Omega == Approx(static_cast<double>(Omegal)).epsilon(1e-11));
+
+    // the prepared profiles use the same kernel.
+    PreparedProfile<double> profile(N, t.data(), T.data());
+    CHECK(Arr(profile) == Approx(static_cast<double>(Omegal)).epsilon(1e-11));
+
+    Arrl.setA(1);
+    Arrl.setEa(2e5);
+    Omegal       = Arrl(N, tl.data(), Tl.data());
+    float Omegaf = Arrf(N, tf.data(), Tf.data());
+    CHECK(Omegaf == Approx(static_cast<double>(Omegal)).epsilon(1e-3));
+  }
+}
+
+TEST_CASE("ArrheniusIntegral Multiple Coefficients", "[integral]")
+{
+  size_t              N = 1000;
+  std::vector<double> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.01 * i;
+    T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+  }
+
+  std::vector<std::pair<double, double>> coefficients = {{3.1e99, 6.28e5}, {2e30, 2e5}, {1, 1e5}, {1, 2e10}};
+
+  ArrheniusIntegral<double> Arr;
+  auto                      Omegas = Arr(N, t.data(), T.data(), coefficients);
+
+  REQUIRE(Omegas.size() == coefficients.size());
+  for (size_t j = 0; j < coefficients.size(); ++j) {
+    Arr.setA(coefficients[j].first);
+    Arr.setEa(coefficients[j].second);
+    CHECK(Omegas[j] == Approx(Arr(N, t.data(), T.data())).epsilon(1e-12));
+  }
+  CHECK(Omegas[3] == 0);
+
+  std::vector<cpp_dec_float_100> tm(t.begin(), t.end()), Tm(T.begin(), T.end());
+  ArrheniusIntegral<cpp_dec_float_100> Arrm;
+  std::vector<cpp_dec_float_100>       As = {3.1e99, 1}, Eas = {6.28e5, 2e10}, Omegasm(2);
+  Arrm(N, tm.data(), Tm.data(), 2, As.data(), Eas.data(), Omegasm.data());
+  for (size_t j = 0; j < 2; ++j) {
+    Arrm.setA(As[j]);
+    Arrm.setEa(Eas[j]);
+    CHECK(static_cast<double>(Omegasm[j] / Arrm(N, tm.data(), Tm.data())) == Approx(1));
+  }
+}
+
+TEST_CASE("ArrheniusIntegral Prepared Profiles", "[integral]")
+{
+  size_t              N = 1000;
+  std::vector<double> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.01 * i;
+    T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+  }
+
+  PreparedProfile<double> profile(N, t.data(), T.data());
+  REQUIRE(profile.size() == N);
+  CHECK(profile.dt()[0] == 0);
+  CHECK(profile.dt()[1] == Approx(0.01));
+  CHECK(profile.invT()[0] == Approx(1 / T[0]));
+  CHECK(profile.dT()[0] == 0);
+  CHECK(profile.dT()[500] == Approx(T[500] - T[0]));
+
+  SECTION("Trapezoid")
+  {
+    ArrheniusIntegral<double> Arr(3.1e99, 6.28e5);
+    CHECK(Arr(profile) == Approx(Arr(N, t.data(), T.data())).epsilon(1e-12));
+
+    std::vector<double> As = {3.1e99, 1}, Eas = {6.28e5, 1e5}, Omegas(2), Omegas2(2);
+    Arr(profile, 2, As.data(), Eas.data(), Omegas.data());
+    Arr(N, t.data(), T.data(), 2, As.data(), Eas.data(), Omegas2.data());
+    CHECK(Omegas == Omegas2);
+  }
+
+  SECTION("Exponential Integral")
+  {
+    ArrheniusIntegral<double, ExponentialIntegral> Arr(3.1e99, 6.28e5);
+    CHECK(Arr(profile) == Approx(Arr(N, t.data(), T.data())).epsilon(1e-12));
+  }
+
+  SECTION("Boost.Multiprecision")
+  {
+    std::vector<cpp_dec_float_100>     tm(t.begin(), t.end()), Tm(T.begin(), T.end());
+    PreparedProfile<cpp_dec_float_100> profilem(N, tm.data(), Tm.data());
+    ArrheniusIntegral<cpp_dec_float_100> Arrm(3.1e99, 6.28e5);
+    CHECK(static_cast<double>(Arrm(profilem) / Arrm(N, tm.data(), Tm.data())) == Approx(1).epsilon(1e-12));
+  }
+}
+
+TEST_CASE("ArrheniusIntegral Mixed Precision", "[integral]")
+{
+  size_t                         N = 1000;
+  std::vector<cpp_dec_float_100> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.01 * i;
+    T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+  }
+
+  ArrheniusIntegral<cpp_dec_float_100>                 Arr(3.1e99, 6.28e5);
+  ArrheniusIntegral<cpp_dec_float_100, MixedPrecision> Arrm(3.1e99, 6.28e5);
+  CHECK(static_cast<double>(Arrm(N, t.data(), T.data()) / Arr(N, t.data(), T.data())) == Approx(1).epsilon(1e-15));
+
+  // the integral doesn't fit in a double
+  Arr.setA(1);
+  Arrm.setA(1);
+  Arr.setEa(1.5e6);
+  Arrm.setEa(1.5e6);
+  CHECK(static_cast<double>(Arrm(N, t.data(), T.data()) / Arr(N, t.data(), T.data())) == Approx(1).epsilon(1e-15));
+
+  // the exponents are too large to be computed accurately, so the full precision method is used.
+  Arr.setEa(1e7);
+  Arrm.setEa(1e7);
+  CHECK(Arrm(N, t.data(), T.data()) == Arr(N, t.data(), T.data()));
+
+  // prepared profiles use the cached time steps and inverse temperatures, for both methods.
+  PreparedProfile<cpp_dec_float_100> profile(N, t.data(), T.data());
+  CHECK(static_cast<double>(Arrm(profile) / Arrm(N, t.data(), T.data())) == Approx(1).epsilon(1e-15));
+  Arrm.setEa(1.5e6);
+  CHECK(static_cast<double>(Arrm(profile) / Arrm(N, t.data(), T.data())) == Approx(1).epsilon(1e-15));
+
+  // works with built-in types too
+  std::vector<double>               td(t.begin(), t.end()), Td(T.begin(), T.end());
+  ArrheniusIntegral<double>         Arrd(3.1e99, 6.28e5);
+  ArrheniusIntegral<double, MixedPrecision> Arrdm(3.1e99, 6.28e5);
+  CHECK(Arrdm(N, td.data(), Td.data()) == Approx(Arrd(N, td.data(), Td.data())).epsilon(1e-13));
+}
+
+TEST_CASE("ArrheniusIntegral Log Domain", "[integral]")
+{
+  size_t                         N = 1000;
+  std::vector<cpp_dec_float_100> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.01 * i;
+    T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+  }
+  std::vector<double> td(t.begin(), t.end()), Td(T.begin(), T.end());
+
+  ArrheniusIntegral<double> Arrd(3.1e99, 6.28e5);
+  CHECK(Arrd.logOmega(N, td.data(), Td.data()) == Approx(log(Arrd(N, td.data(), Td.data()))).epsilon(1e-13));
+
+  PreparedProfile<double> profile(N, td.data(), Td.data());
+  CHECK(Arrd.logOmega(profile) == Approx(Arrd.logOmega(N, td.data(), Td.data())).epsilon(1e-14));
+
+  ArrheniusIntegral<cpp_dec_float_100> Arr(3.1e99, 6.28e5);
+  CHECK(abs(Arr.logOmega(N, t.data(), T.data()) - log(Arr(N, t.data(), T.data()))) < 1e-80);
+
+  // the integral underflows in double, but log(Omega) doesn't.
+  Arrd.setA(1);
+  Arrd.setEa(3e6);
+  Arr.setA(1);
+  Arr.setEa(3e6);
+  CHECK(Arrd(N, td.data(), Td.data()) == 0);
+  CHECK(Arrd.logOmega(N, td.data(), Td.data()) == Approx(static_cast<double>(log(Arr(N, t.data(), T.data())))).epsilon(1e-13));
+
+  // several coefficients at once
+  std::vector<double> As = {1, 2, 3.1e99}, Eas = {6.28e5, 3e6, 6.28e5}, logOmegas(3);
+  Arrd.logOmega(profile, 3, As.data(), Eas.data(), logOmegas.data());
+  for (size_t j = 0; j < 3; ++j) {
+    Arrd.setA(As[j]);
+    Arrd.setEa(Eas[j]);
+    CHECK(logOmegas[j] == Approx(Arrd.logOmega(profile)).epsilon(1e-14));
+  }
+
+  PreparedProfile<cpp_dec_float_100> profilem(N, t.data(), T.data());
+  std::vector<cpp_dec_float_100>     Asm(As.begin(), As.end()), Easm(Eas.begin(), Eas.end()), logOmegasm(3);
+  Arr.logOmega(profilem, 3, Asm.data(), Easm.data(), logOmegasm.data());
+  for (size_t j = 0; j < 3; ++j) {
+    Arr.setA(Asm[j]);
+    Arr.setEa(Easm[j]);
+    CHECK(abs(logOmegasm[j] - Arr.logOmega(profilem)) < 1e-80);
+  }
+
+  // temperatures must be positive
+  Td[10] = -1;
+  CHECK(std::isnan(Arrd.logOmega(N, td.data(), Td.data())));
+  PreparedProfile<double> invalid(N, td.data(), Td.data());
+  Arrd.logOmega(invalid, 3, As.data(), Eas.data(), logOmegas.data());
+  CHECK(std::isnan(logOmegas[0]));
+}
+
+TEST_CASE("ArrheniusIntegral Parallel Reduction", "[integral]")
+{
+  // every interval is used, including the first.
+  std::vector<double> t = {0, 1, 2}, T = {310, 310, 310};
+  ArrheniusIntegral<double> Arr3(3.1e99, 6.28e5);
+  CHECK(Arr3(3, t.data(), T.data()) == Approx(3.1e99 * exp(-6.28e5 / (MKS::R * 310)) * 2));
+
+  size_t                         N = 5000;
+  std::vector<cpp_dec_float_100> tm(N), Tm(N);
+  for (size_t i = 0; i < N; i++) {
+    tm[i] = 0.002 * i;
+    Tm[i] = 310 + 20 * exp(-pow((tm[i] - 5) / 2, 2));
+  }
+  std::vector<double> td(tm.begin(), tm.end()), Td(Tm.begin(), Tm.end());
+
+  // the parallel and serial results must be identical.
+  SECTION("Trapezoid")
+  {
+    ArrheniusIntegral<double> Arr(3.1e99, 6.28e5);
+    Arr.setParallelThreshold(N + 1);
+    double serial = Arr(N, td.data(), Td.data());
+    Arr.setParallelThreshold(1);
+    CHECK(Arr(N, td.data(), Td.data()) == serial);
+
+    ArrheniusIntegral<cpp_dec_float_100> Arrm(3.1e99, 6.28e5);
+    Arrm.setParallelThreshold(N + 1);
+    cpp_dec_float_100 serialm = Arrm(N, tm.data(), Tm.data());
+    Arrm.setParallelThreshold(1);
+    CHECK(Arrm(N, tm.data(), Tm.data()) == serialm);
+    CHECK(static_cast<double>(serialm) == Approx(serial).epsilon(1e-13));
+  }
+
+  SECTION("Exponential Integral")
+  {
+    ArrheniusIntegral<double, ExponentialIntegral> Arr(3.1e99, 6.28e5);
+    Arr.setParallelThreshold(N + 1);
+    double serial = Arr(N, td.data(), Td.data());
+    Arr.setParallelThreshold(1);
+    CHECK(Arr(N, td.data(), Td.data()) == serial);
+
+    PreparedProfile<double> profile(N, td.data(), Td.data());
+    CHECK(Arr(profile) == Approx(serial).epsilon(1e-12));
+  }
+}
+
+TEST_CASE("ArrheniusIntegral Adaptive", "[integral]")
+{
+  size_t              N = 20001;
+  std::vector<double> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.001 * i;
+    T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+  }
+
+  ArrheniusIntegral<double>                      Arrt(3.1e99, 6.28e5);
+  ArrheniusIntegral<double, ExponentialIntegral> Arre(3.1e99, 6.28e5);
+  ArrheniusIntegral<double, Adaptive>            Arra(3.1e99, 6.28e5);
+  CHECK(Arra.getTolerance() == 1e-8);
+  CHECK(Arra(N, t.data(), T.data()) == Approx(Arrt(N, t.data(), T.data())).epsilon(1e-7));
+  // the methods differ by the O(dt^2) error of the sampling.
+  CHECK(Arra(N, t.data(), T.data()) == Approx(Arre(N, t.data(), T.data())).epsilon(1e-6));
+
+  PreparedProfile<double> profile(N, t.data(), T.data());
+  CHECK(Arra(profile) == Arra(N, t.data(), T.data()));
+
+  // a single sample spike between the nodes is found.
+  double smooth = Arre(N, t.data(), T.data());
+  T[12345] = 360;
+  double spiked = Arre(N, t.data(), T.data());
+  CHECK(spiked > 1.1 * smooth);
+  CHECK(Arra(N, t.data(), T.data()) == Approx(spiked).epsilon(1e-6));
+
+  // tighter tolerances converge to the integral of the interpolated profile.
+  Arra.setTolerance(1e-11);
+  double tight = Arra(N, t.data(), T.data());
+  Arra.setTolerance(0);
+  CHECK(Arra(N, t.data(), T.data()) == Approx(tight).epsilon(1e-10));
+
+  // short profiles and multiprecision types work too.
+  std::vector<cpp_dec_float_100> tm(t.begin(), t.begin() + 3), Tm(T.begin(), T.begin() + 3);
+  ArrheniusIntegral<cpp_dec_float_100, Adaptive> Arrm(3.1e99, 6.28e5);
+  ArrheniusIntegral<cpp_dec_float_100>           Arrmt(3.1e99, 6.28e5);
+  CHECK(static_cast<double>(Arrm(3, tm.data(), Tm.data()) / Arrmt(3, tm.data(), Tm.data())) == Approx(1).epsilon(1e-9));
+  CHECK(Arrm(1, tm.data(), Tm.data()) == 0);
+}
+
+TEST_CASE("ArrheniusIntegral Pruned", "[integral]")
+{
+  // an exposure followed by a long cool down.
+  size_t              N = 100001;
+  std::vector<double> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.001 * i;
+    T[i] = 310 + (t[i] < 1 ? 30 * t[i] : 30 * exp(-(t[i] - 1) / 0.5));
+  }
+
+  ArrheniusIntegral<double>         Arr(3.1e99, 6.28e5);
+  ArrheniusIntegral<double, Pruned> Arrp(3.1e99, 6.28e5);
+  double                            full = Arr(N, t.data(), T.data());
+  CHECK(Arrp.getTolerance() == 1e-8);
+
+  // the discarded part is never larger than the tolerance.
+  for (double tol : {1e-4, 1e-6, 1e-8}) {
+    Arrp.setTolerance(tol);
+    double pruned = Arrp(N, t.data(), T.data());
+    CHECK(pruned <= full);
+    CHECK(full - pruned <= tol * full);
+  }
+
+  PreparedProfile<double> profile(N, t.data(), T.data());
+  CHECK(Arrp(profile) == Approx(Arrp(N, t.data(), T.data())).epsilon(1e-12));
+
+  // a tolerance of zero gives the trapezoid rule.
+  Arrp.setTolerance(0);
+  CHECK(Arrp(N, t.data(), T.data()) == full);
+
+  std::vector<cpp_dec_float_100>            tm(t.begin(), t.begin() + 2000), Tm(T.begin(), T.begin() + 2000);
+  ArrheniusIntegral<cpp_dec_float_100>         Arrm(3.1e99, 6.28e5);
+  ArrheniusIntegral<cpp_dec_float_100, Pruned> Arrmp(3.1e99, 6.28e5);
+  Arrmp.setTolerance(0);
+  CHECK(Arrmp(2000, tm.data(), Tm.data()) == Arrm(2000, tm.data(), Tm.data()));
+  CHECK(Arrmp(1, tm.data(), Tm.data()) == 0);
+}
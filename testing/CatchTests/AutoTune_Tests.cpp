@@ -0,0 +1,104 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include <libArrhenius/Integration/ArrheniusIntegral.hpp>
+#include <libArrhenius/Integration/ModifiedArrheniusIntegral.hpp>
+#include <libArrhenius/Integration/AutoTune.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace libArrhenius;
+
+TEST_CASE("ParallelThresholdCache Usage", "[integral]")
+{
+  std::string filename = "AutoTune_Tests-cache.txt";
+  std::remove(filename.c_str());
+
+  ParallelThresholdCache cache(filename);
+  std::size_t threshold = 0;
+  CHECK(!cache.lookup("a", threshold));
+
+  cache.store("a", 1024);
+  cache.store("b", 2048);
+  CHECK(cache.lookup("a", threshold));
+  CHECK(threshold == 1024);
+  CHECK(cache.lookup("b", threshold));
+  CHECK(threshold == 2048);
+
+  // entries are replaced, not duplicated
+  cache.store("a", 512);
+  CHECK(ParallelThresholdCache(filename).lookup("a", threshold));
+  CHECK(threshold == 512);
+  CHECK(ParallelThresholdCache(filename).lookup("b", threshold));
+  CHECK(threshold == 2048);
+
+  // an empty filename disables the cache
+  ParallelThresholdCache none("");
+  none.store("a", 1);
+  CHECK(!none.lookup("a", threshold));
+
+  // the directory is created if it doesn't exist
+  boost::filesystem::remove_all("AutoTune_Tests-dir");
+  ParallelThresholdCache nested("AutoTune_Tests-dir/cache/thresholds.txt");
+  nested.store("a", 256);
+  CHECK(ParallelThresholdCache("AutoTune_Tests-dir/cache/thresholds.txt").lookup("a", threshold));
+  CHECK(threshold == 256);
+  // and the temporary file is renamed into place
+  CHECK(std::distance(boost::filesystem::directory_iterator("AutoTune_Tests-dir/cache"), boost::filesystem::directory_iterator()) == 1);
+  boost::filesystem::remove_all("AutoTune_Tests-dir");
+
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("ParallelThresholdTuner Usage", "[integral]")
+{
+  std::size_t threshold = ParallelThresholdTuner<ArrheniusIntegral<double>>::calibrate(4096);
+  CHECK(threshold >= 512);
+  if (ParallelThresholdTuner<ArrheniusIntegral<double>>::maxThreads() < 2)
+    CHECK(ParallelThresholdTuner<ArrheniusIntegral<double>>::tuned(ParallelThresholdCache("")) == std::numeric_limits<std::size_t>::max());
+
+  // the key depends on the integrator type
+  CHECK(ParallelThresholdTuner<ArrheniusIntegral<double>>::key() != ParallelThresholdTuner<ArrheniusIntegral<float>>::key());
+  CHECK(ParallelThresholdTuner<ArrheniusIntegral<double>>::key() != ParallelThresholdTuner<ModifiedArrheniusIntegral<double>>::key());
+
+  // and on the machine, which can't contain white space.
+  std::string machine = ParallelThresholdCache::machineId();
+  CHECK(!machine.empty());
+  CHECK(machine.find_first_of(" \t\n") == std::string::npos);
+  CHECK(ParallelThresholdTuner<ArrheniusIntegral<double>>::key().compare(0, machine.size(), machine) == 0);
+  CHECK(ParallelThresholdTuner<ModifiedArrheniusIntegral<double>>::calibrate(1024) >= 512);
+  CHECK(ParallelThresholdTuner<ArrheniusIntegral<double, ExponentialIntegral>>::calibrate(1024) >= 512);
+}
+
+TEST_CASE("AutoTuned Usage", "[integral]")
+{
+  size_t              N = 5000;
+  std::vector<double> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.002 * i;
+    T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+  }
+
+  // keep the calibration out of the user's cache.
+  std::string filename = "AutoTune_Tests-tuned.txt";
+  const char *previous = std::getenv("LIBARRHENIUS_TUNING_CACHE");
+  std::string saved = previous ? previous : "";
+  setenv("LIBARRHENIUS_TUNING_CACHE", filename.c_str(), 1);
+  AutoTuned<ArrheniusIntegral<double>> integrate(3.1e99, 6.28e5);
+  if (previous)
+    setenv("LIBARRHENIUS_TUNING_CACHE", saved.c_str(), 1);
+  else
+    unsetenv("LIBARRHENIUS_TUNING_CACHE");
+  std::remove(filename.c_str());
+
+  ArrheniusIntegral<double>            reference(3.1e99, 6.28e5);
+  CHECK(integrate.getParallelThreshold() >= 512);
+
+  // the threshold only changes how the work is divided, not the result.
+  CHECK(integrate(N, t.data(), T.data()) == reference(N, t.data(), T.data()));
+}
@@ -0,0 +1,56 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include <libArrhenius/Integration/ArrheniusIntegral.hpp>
+#include <libArrhenius/Integration/ModifiedArrheniusIntegral.hpp>
+#include <libArrhenius/Integration/BatchIntegrator.hpp>
+
+using namespace libArrhenius;
+using namespace libArrhenius::Constants;
+
+TEST_CASE("BatchIntegrator Usage", "[integral]")
+{
+  std::vector<double> taus = {0.001, 0.01, 0.1, 1.0, 10.0};
+  ProfileSet<double>  profiles;
+
+  for (auto tau : taus) {
+    double              dt = tau / 20;
+    size_t              N  = 4 * tau / dt;
+    std::vector<double> t(N), T(N);
+    for (size_t i = 0; i < N; i++) {
+      t[i] = dt * i;
+      T[i] = 310;
+      if (t[i] > tau / 2) T[i] = 10 + 310;
+      if (t[i] > tau + tau / 2) T[i] = 310;
+    }
+    profiles.addProfile(N, t.data(), T.data());
+  }
+
+  REQUIRE(profiles.size() == taus.size());
+  CHECK(profiles.N(0) == 80);
+  CHECK(profiles.samples() == 5 * 80);
+
+  SECTION("Trapezoid")
+  {
+    BatchIntegrator<ArrheniusIntegral<double>> integrate(3.1e99, 6.28e5);
+    auto Omegas = integrate(profiles);
+
+    REQUIRE(Omegas.size() == taus.size());
+    for (size_t i = 0; i < profiles.size(); ++i)
+      CHECK(Omegas[i] == integrate(profiles.N(i), profiles.t(i), profiles.T(i)));
+
+    std::vector<double> Omegas2(profiles.size());
+    integrate(profiles.size(), profiles.offsetData(), profiles.tData(), profiles.TData(), Omegas2.data());
+    CHECK(Omegas2 == Omegas);
+  }
+
+  SECTION("Modified Arrhenius")
+  {
+    BatchIntegrator<ModifiedArrheniusIntegral<double>> integrate(3.1e99, 6.28e5, 1);
+    auto Omegas = integrate(profiles);
+
+    for (size_t i = 0; i < profiles.size(); ++i)
+      CHECK(Omegas[i] == integrate(profiles.N(i), profiles.t(i), profiles.T(i)));
+  }
+}
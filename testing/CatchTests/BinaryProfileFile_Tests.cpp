@@ -0,0 +1,134 @@
+#include "catch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <libArrhenius/Integration/ArrheniusIntegral.hpp>
+#include <libArrhenius/Integration/BatchIntegrator.hpp>
+#include <libArrhenius/Profiles/BinaryProfileFile.hpp>
+#include <libArrhenius/ThresholdCalculator.hpp>
+
+using namespace libArrhenius;
+
+TEST_CASE("BinaryProfileFile Usage", "[profiles]")
+{
+  std::vector<double> taus = {0.001, 0.01, 0.1, 1.0, 10.0};
+  ProfileSet<double>  profiles;
+
+  for (auto tau : taus) {
+    double              dt = tau / 20;
+    size_t              N  = 4 * tau / dt;
+    std::vector<double> t(N), T(N);
+    for (size_t i = 0; i < N; i++) {
+      t[i] = dt * i;
+      T[i] = 310;
+      if (t[i] > tau / 2) T[i] = 10 + 310;
+      if (t[i] > tau + tau / 2) T[i] = 310;
+    }
+    profiles.addProfile(N, t.data(), T.data());
+  }
+
+  std::string filename = "BinaryProfileFile_Tests.bin";
+  writeBinaryProfiles(filename, profiles);
+  CHECK(isBinaryProfileFile(filename));
+
+  SECTION("Mapped Profiles")
+  {
+    MappedProfileFile<double> file(filename);
+    REQUIRE(file.size() == profiles.size());
+    CHECK(file.samples() == profiles.samples());
+    for (size_t i = 0; i < file.size(); i++) {
+      REQUIRE(file.N(i) == profiles.N(i));
+      for (size_t j = 0; j < file.N(i); j++) {
+        CHECK(file.t(i)[j] == profiles.t(i)[j]);
+        CHECK(file.T(i)[j] == profiles.T(i)[j]);
+      }
+    }
+
+    // the arrays are aligned for the vectorized kernels.
+    CHECK(reinterpret_cast<std::uintptr_t>(file.tData()) % 64 == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(file.TData()) % 64 == 0);
+  }
+
+  SECTION("Integration")
+  {
+    MappedProfileFile<double>                    file(filename);
+    BatchIntegrator<ArrheniusIntegral<double>>   integrate(3.1e99, 6.28e5);
+    ThresholdCalculator<ArrheniusIntegral<double>> calc(3.1e99, 6.28e5);
+
+    auto Omega      = integrate(file);
+    auto expected   = integrate(profiles);
+    auto thresholds = calc(file);
+    auto expected_thresholds = calc(profiles);
+    REQUIRE(Omega.size() == taus.size());
+    REQUIRE(thresholds.size() == taus.size());
+    for (size_t i = 0; i < taus.size(); i++) {
+      CHECK(Omega[i] == expected[i]);
+      CHECK(thresholds[i] == expected_thresholds[i]);
+    }
+  }
+
+  SECTION("Single Profile")
+  {
+    writeBinaryProfile(filename, profiles.N(2), profiles.t(2), profiles.T(2));
+    MappedProfileFile<double> file(filename);
+    REQUIRE(file.size() == 1);
+    REQUIRE(file.N(0) == profiles.N(2));
+    CHECK(file.t(0)[file.N(0) - 1] == profiles.t(2)[profiles.N(2) - 1]);
+    CHECK(file.T(0)[file.N(0) - 1] == profiles.T(2)[profiles.N(2) - 1]);
+  }
+
+  SECTION("Errors")
+  {
+    // wrong scalar type
+    CHECK_THROWS_AS(MappedProfileFile<float>(filename), std::runtime_error);
+
+    // missing file
+    CHECK_THROWS_AS(MappedProfileFile<double>("missing.bin"), std::runtime_error);
+
+    // not a binary profile file
+    {
+      std::ofstream out("BinaryProfileFile_Tests.txt");
+      out << "0 310\n1 320\n2 310\n";
+      for (int i = 0; i < 20; i++) out << "# padding to make the file larger than the header\n";
+    }
+    CHECK(!isBinaryProfileFile("BinaryProfileFile_Tests.txt"));
+    CHECK_THROWS_AS(MappedProfileFile<double>("BinaryProfileFile_Tests.txt"), std::runtime_error);
+
+    // truncated
+    {
+      std::ifstream in(filename, std::ios::binary);
+      std::vector<char> data(200);
+      in.read(data.data(), data.size());
+      std::ofstream out("BinaryProfileFile_Tests.truncated.bin", std::ios::binary);
+      out.write(data.data(), in.gcount());
+    }
+    CHECK_THROWS_AS(MappedProfileFile<double>("BinaryProfileFile_Tests.truncated.bin"), std::runtime_error);
+
+    // counts in the header that would wrap around when the section positions are computed.
+    auto corrupt = [&](size_t position, std::uint64_t value) {
+      std::ifstream     in(filename, std::ios::binary);
+      std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      std::memcpy(data.data() + position, &value, sizeof(value));
+      std::ofstream out("BinaryProfileFile_Tests.corrupt.bin", std::ios::binary);
+      out.write(data.data(), data.size());
+    };
+    corrupt(offsetof(BinaryProfileHeader, profiles), std::uint64_t(1) << 61);
+    CHECK_THROWS_AS(MappedProfileFile<double>("BinaryProfileFile_Tests.corrupt.bin"), std::runtime_error);
+    corrupt(offsetof(BinaryProfileHeader, profiles), ~std::uint64_t(0));
+    CHECK_THROWS_AS(MappedProfileFile<double>("BinaryProfileFile_Tests.corrupt.bin"), std::runtime_error);
+    corrupt(offsetof(BinaryProfileHeader, samples), std::uint64_t(1) << 61);
+    CHECK_THROWS_AS(MappedProfileFile<double>("BinaryProfileFile_Tests.corrupt.bin"), std::runtime_error);
+    std::remove("BinaryProfileFile_Tests.corrupt.bin");
+  }
+
+  std::remove(filename.c_str());
+  std::remove("BinaryProfileFile_Tests.txt");
+  std::remove("BinaryProfileFile_Tests.truncated.bin");
+}
@@ -0,0 +1,116 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include <libArrhenius/Integration/ArrheniusIntegral.hpp>
+#include <libArrhenius/Integration/ModifiedArrheniusIntegral.hpp>
+#include <libArrhenius/Integration/DamageAccumulator.hpp>
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+using namespace boost::multiprecision;
+
+using namespace libArrhenius;
+using namespace libArrhenius::Constants;
+
+TEST_CASE("DamageAccumulator Usage", "[integral]")
+{
+  size_t              N = 1000;
+  std::vector<double> t(N), T(N);
+  for (size_t i = 0; i < N; i++) {
+    t[i] = 0.01 * i;
+    T[i] = 310 + 20 * exp(-pow((t[i] - 5) / 2, 2));
+  }
+
+  double A  = 3.1e99;
+  double Ea = 6.28e5;
+
+  SECTION("One Sample at a Time")
+  {
+    DamageAccumulator<double> damage(A, Ea);
+    CHECK(damage.Omega() == 0);
+    ArrheniusIntegral<double> integrate(A, Ea);
+    for (size_t i = 0; i < N; i++) {
+      damage.add(t[i], T[i]);
+      if (i % 100 == 0) CHECK(damage.Omega() == Approx(integrate(i + 1, t.data(), T.data())).epsilon(1e-12));
+    }
+    CHECK(damage.size() == N);
+    CHECK(damage.Omega() == Approx(integrate(N, t.data(), T.data())).epsilon(1e-12));
+
+    damage.reset();
+    CHECK(damage.size() == 0);
+    CHECK(damage.Omega() == 0);
+  }
+
+  SECTION("Chunks")
+  {
+    DamageAccumulator<double> damage(A, Ea), reference(A, Ea);
+    damage.add(300, t.data(), T.data());
+    damage.add(N - 300, t.data() + 300, T.data() + 300);
+    for (size_t i = 0; i < N; i++) reference.add(t[i], T[i]);
+    CHECK(damage.Omega() == Approx(reference.Omega()).epsilon(1e-14));
+  }
+
+  SECTION("Modified Arrhenius")
+  {
+    DamageAccumulator<double>         damage(A, Ea, 1.5);
+    ModifiedArrheniusIntegral<double> integrate(A, Ea, 1.5);
+    damage.add(N, t.data(), T.data());
+    CHECK(damage.Omega() == Approx(integrate(N, t.data(), T.data())).epsilon(1e-12));
+  }
+
+  SECTION("Multiprecision")
+  {
+    std::vector<cpp_dec_float_100>         tm(t.begin(), t.end()), Tm(T.begin(), T.end());
+    DamageAccumulator<cpp_dec_float_100>   damage(A, Ea);
+    ArrheniusIntegral<cpp_dec_float_100>   integrate(A, Ea);
+    damage.add(N, tm.data(), Tm.data());
+    CHECK(static_cast<double>(damage.Omega() / integrate(N, tm.data(), Tm.data())) == Approx(1).epsilon(1e-30));
+  }
+}
+
+TEST_CASE("DamageAccumulator Threshold Time", "[integral]")
+{
+  double A  = 3.1e99;
+  double Ea = 6.28e5;
+
+  SECTION("Constant Temperature")
+  {
+    // Omega = A*exp(-Ea/RT)*t, so the threshold is reached at 1/(A*exp(-Ea/RT))
+    double                    T = 330;
+    double                    tau = 1 / (A * exp(-Ea / (MKS::R * T)));
+    DamageAccumulator<double> damage(A, Ea);
+    double                    dt = tau / 7.3;
+    for (int i = 0; i < 7; i++) damage.add(i * dt, T);
+    CHECK(!damage.thresholdTime().is_initialized());
+    damage.add(7 * dt, T);
+    CHECK(!damage.thresholdTime().is_initialized());
+    damage.add(8 * dt, T);
+    REQUIRE(damage.thresholdTime().is_initialized());
+    CHECK(*damage.thresholdTime() == Approx(tau).epsilon(1e-12));
+
+    // the first crossing is kept
+    damage.add(20 * dt, T);
+    CHECK(*damage.thresholdTime() == Approx(tau).epsilon(1e-12));
+  }
+
+  SECTION("Linear Rate")
+  {
+    // with the rate increasing linearly across one interval, the damage is quadratic in time.
+    double                    T0 = 330, T1 = 340;
+    double                    k0 = A * exp(-Ea / (MKS::R * T0));
+    double                    k1 = A * exp(-Ea / (MKS::R * T1));
+    double                    dt = 2 / (k0 + k1) * 2; // Omega reaches 2 at the end of the interval
+    DamageAccumulator<double> damage(A, Ea);
+    damage.add(0, T0);
+    damage.add(dt, T1);
+    REQUIRE(damage.thresholdTime().is_initialized());
+    double s = *damage.thresholdTime();
+    CHECK(k0 * s + (k1 - k0) * s * s / (2 * dt) == Approx(1).epsilon(1e-12));
+
+    damage.setThresholdOmega(10);
+    damage.reset();
+    damage.add(0, T0);
+    damage.add(dt, T1);
+    CHECK(!damage.thresholdTime().is_initialized());
+  }
+}
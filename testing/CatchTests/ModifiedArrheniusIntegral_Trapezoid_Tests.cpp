@@ -37,3 +37,65 @@ TEST_CASE( "ModifiedArrheniusIntegral With n=0", "[trapezoid]" ) {
 
 }
 
+
+TEST_CASE( "ModifiedArrheniusIntegral Mixed Precision", "[trapezoid]" ) {
+
+  size_t N = 1000;
+  std::vector<double> t(N), T(N);
+
+  for( size_t i = 0; i < t.size(); i++ )
+  {
+    t[i] = 0.01*i;
+    T[i] = 310 + 20*exp(-pow((t[i]-5)/2,2));
+  }
+
+  ModifiedArrheniusIntegral<double> Arr(3.1e99,6.28e5,1.5);
+  ModifiedArrheniusIntegral<double,MixedPrecision> Arrm(3.1e99,6.28e5,1.5);
+
+  CHECK( Arrm(N,t.data(),T.data()) == Approx( Arr(N,t.data(),T.data()) ).epsilon(1e-13) );
+
+  PreparedProfile<double> profile(N,t.data(),T.data());
+  CHECK( Arrm(profile) == Approx( Arrm(N,t.data(),T.data()) ).epsilon(1e-14) );
+
+}
+
+TEST_CASE( "ModifiedArrheniusIntegral Log Domain", "[trapezoid]" ) {
+
+  size_t N = 1000;
+  std::vector<double> t(N), T(N);
+
+  for( size_t i = 0; i < t.size(); i++ )
+  {
+    t[i] = 0.01*i;
+    T[i] = 310 + 20*exp(-pow((t[i]-5)/2,2));
+  }
+
+  ModifiedArrheniusIntegral<double> Arr(3.1e99,6.28e5,1.5);
+  CHECK( Arr.logOmega(N,t.data(),T.data()) == Approx( log(Arr(N,t.data(),T.data())) ).epsilon(1e-13) );
+
+  PreparedProfile<double> profile(N,t.data(),T.data());
+  CHECK( Arr.logOmega(profile) == Approx( Arr.logOmega(N,t.data(),T.data()) ).epsilon(1e-14) );
+
+}
+
+TEST_CASE( "ModifiedArrheniusIntegral Parallel Reduction", "[trapezoid]" ) {
+
+  size_t N = 5000;
+  std::vector<double> t(N), T(N);
+
+  for( size_t i = 0; i < t.size(); i++ )
+  {
+    t[i] = 0.002*i;
+    T[i] = 310 + 20*exp(-pow((t[i]-5)/2,2));
+  }
+
+  ModifiedArrheniusIntegral<double> Arr(3.1e99,6.28e5,1.5);
+  Arr.setParallelThreshold(N+1);
+  double serial = Arr(N,t.data(),T.data());
+  Arr.setParallelThreshold(1);
+  CHECK( Arr(N,t.data(),T.data()) == serial );
+
+  PreparedProfile<double> profile(N,t.data(),T.data());
+  CHECK( Arr(profile) == Approx( serial ).epsilon(1e-14) );
+
+}
@@ -0,0 +1,110 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libArrhenius/Profiles/ProfileLoader.hpp>
+
+using namespace libArrhenius;
+
+TEST_CASE("ProfileLoader Usage", "[profiles]")
+{
+  // profile i has i+1 samples.
+  size_t                   M = 20;
+  std::vector<std::string> files;
+  for (size_t i = 0; i < M; i++) {
+    files.push_back("ProfileLoader_Tests_" + std::to_string(i) + ".txt");
+    std::ofstream out(files.back());
+    for (size_t j = 0; j <= i; j++) out << 0.5 * j << " " << 310 + i << "\n";
+  }
+
+  SECTION("In Order")
+  {
+    ProfileLoader<double>          loader(files, 3, 2);
+    ProfileLoader<double>::Profile profile;
+    CHECK(loader.size() == M);
+    size_t count = 0;
+    while (loader.next(profile)) {
+      CHECK(profile.index == count);
+      CHECK(profile.filename == files[count]);
+      REQUIRE(profile.t.size() == count + 1);
+      REQUIRE(profile.T.size() == count + 1);
+      CHECK(profile.t[count] == 0.5 * count);
+      CHECK(profile.T[0] == 310 + count);
+      count++;
+    }
+    CHECK(count == M);
+    CHECK(!loader.next(profile));
+  }
+
+  SECTION("Missing File")
+  {
+    files[5] = "missing.txt";
+    ProfileLoader<double>          loader(files, 4);
+    ProfileLoader<double>::Profile profile;
+    for (size_t i = 0; i < 5; i++) {
+      REQUIRE(loader.next(profile));
+      CHECK(profile.index == i);
+    }
+    CHECK_THROWS_AS(loader.next(profile), std::runtime_error);
+    // the rest of the files are still available.
+    REQUIRE(loader.next(profile));
+    CHECK(profile.index == 6);
+  }
+
+  SECTION("Early Exit")
+  {
+    // the loader threads are stopped when the loader is destroyed, even if they are blocked.
+    ProfileLoader<double>          loader(files, 2, 1);
+    ProfileLoader<double>::Profile profile;
+    REQUIRE(loader.next(profile));
+  }
+
+  SECTION("Binary Files")
+  {
+    // profiles 3 and 4 in one binary file, in float, and profile 6 on its own.
+    std::vector<float>  tf, Tf;
+    std::vector<size_t> offsets = {0};
+    for (size_t i = 3; i <= 4; i++) {
+      for (size_t j = 0; j <= i; j++) {
+        tf.push_back(0.5 * j);
+        Tf.push_back(310 + i);
+      }
+      offsets.push_back(tf.size());
+    }
+    writeBinaryProfiles("ProfileLoader_Tests_34.bin", 2, offsets.data(), tf.data(), Tf.data());
+    std::vector<double> t6, T6;
+    ProfileLoader<double>::load(files[6], t6, T6);
+    writeBinaryProfile("ProfileLoader_Tests_6.bin", t6.size(), t6.data(), T6.data());
+
+    ProfileLoader<double>          loader({files[2], "ProfileLoader_Tests_34.bin", "ProfileLoader_Tests_6.bin"}, 2);
+    ProfileLoader<double>::Profile profile;
+    CHECK(loader.size() == 3);
+    std::vector<std::string> names = {files[2], "ProfileLoader_Tests_34.bin:0", "ProfileLoader_Tests_34.bin:1", "ProfileLoader_Tests_6.bin"};
+    std::vector<size_t>      which = {2, 3, 4, 6};
+    for (size_t k = 0; k < 4; k++) {
+      REQUIRE(loader.next(profile));
+      CHECK(profile.index == k);
+      CHECK(profile.filename == names[k]);
+      REQUIRE(profile.t.size() == which[k] + 1);
+      CHECK(profile.t[which[k]] == 0.5 * which[k]);
+      CHECK(profile.T[0] == 310 + which[k]);
+    }
+    CHECK(!loader.next(profile));
+
+    std::remove("ProfileLoader_Tests_34.bin");
+    std::remove("ProfileLoader_Tests_6.bin");
+  }
+
+  SECTION("No Files")
+  {
+    ProfileLoader<double>          loader(std::vector<std::string>{});
+    ProfileLoader<double>::Profile profile;
+    CHECK(!loader.next(profile));
+  }
+
+  for (size_t i = 0; i < M; i++) std::remove(("ProfileLoader_Tests_" + std::to_string(i) + ".txt").c_str());
+}
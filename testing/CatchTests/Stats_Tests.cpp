@@ -0,0 +1,98 @@
+#include "catch.hpp"
+
+#include <sstream>
+#include <vector>
+
+#include <libArrhenius/Integration/ArrheniusIntegral.hpp>
+#include <libArrhenius/Fitting/ArrheniusFit.hpp>
+#include <libArrhenius/Stats.hpp>
+#include <libArrhenius/ThresholdCalculator.hpp>
+
+using namespace libArrhenius;
+
+// the unit tests are compiled with LIBARRHENIUS_STATS (see testing/CMakeLists.txt).
+TEST_CASE("Stats Usage", "[stats]")
+{
+  REQUIRE(Stats::enabled);
+
+  double A  = 3.1e99;
+  double Ea = 6.28e5;
+
+  // square pulses scaled to threshold, like the fitting tests.
+  std::vector<double>              taus = {0.001, 0.01, 0.1, 1.0, 10.0};
+  std::vector<std::vector<double>> ts, Ts;
+  ThresholdCalculator<ArrheniusIntegral<double>> calc(A, Ea);
+  for (auto tau : taus) {
+    size_t              N = 80;
+    std::vector<double> t(N), T(N);
+    for (size_t i = 0; i < N; i++) {
+      t[i] = tau / 20 * i;
+      T[i] = 310;
+      if (t[i] > tau / 2) T[i] = 10 + 310;
+      if (t[i] > tau + tau / 2) T[i] = 310;
+    }
+    double threshold = calc(N, t.data(), T.data());
+    for (size_t i = 0; i < N; i++) T[i] = threshold * (T[i] - T[0]) + T[0];
+    ts.push_back(t);
+    Ts.push_back(T);
+  }
+
+  Stats::reset();
+  Stats::Report r = Stats::report();
+  for (int c = 0; c < Stats::NumCounters; ++c) CHECK(r.counts[c] == 0);
+  for (int p = 0; p < Stats::NumPhases; ++p) CHECK(r.calls[p] == 0);
+
+  SECTION("Threshold")
+  {
+    calc(ts[2].size(), ts[2].data(), Ts[2].data());
+    r = Stats::report();
+    CHECK(r[Stats::ThresholdSolves] == 1);
+    CHECK(r[Stats::RootIterations] > 0);
+    CHECK(r[Stats::Integrations] > 0);
+    CHECK(r[Stats::Samples] == 80 * r[Stats::Integrations]);
+    CHECK(r.calls[Stats::Threshold] == 1);
+    CHECK(r.calls[Stats::Fit] == 0);
+  }
+
+  SECTION("Fit")
+  {
+    ArrheniusFit<double, MinimizeLogAVarianceAndScalingFactors> fit;
+    for (size_t j = 0; j < ts.size(); ++j) fit.addProfile(ts[j].size(), ts[j].data(), Ts[j].data());
+    fit.exec();
+
+    r = Stats::report();
+    CHECK(r.calls[Stats::Fit] == 1);
+    CHECK(r.calls[Stats::UpperBoundSearch] == 1);
+    CHECK(r.calls[Stats::Scan] == 1);
+    CHECK(r.calls[Stats::EaMinimization] == 1);
+    CHECK(r.calls[Stats::AMinimization] == 1);
+    // every A cost evaluation solves for the thresholds of all the profiles.
+    CHECK(r.calls[Stats::Threshold] > 0);
+    CHECK(r[Stats::ThresholdSolves] == taus.size() * r.calls[Stats::Threshold]);
+    CHECK(r[Stats::MinimizerIterations] > 0);
+    CHECK(r[Stats::CostEvaluations] > r[Stats::MinimizerIterations]);
+    CHECK(r[Stats::ExpCalls] >= r[Stats::Samples]);
+    CHECK(r.seconds[Stats::Fit] >= r.seconds[Stats::AMinimization]);
+    CHECK(r.seconds[Stats::AMinimization] >= r.seconds[Stats::Threshold]);
+
+    std::ostringstream out;
+    r.print(out);
+    CHECK(out.str().find("threshold solves") != std::string::npos);
+
+    Stats::reset();
+    CHECK(Stats::report()[Stats::Integrations] == 0);
+  }
+
+  SECTION("Several Coefficients per Pass")
+  {
+    // the scan reads each profile once for all of the Ea values on its grid.
+    ArrheniusFit<double, EffectiveExposuresLinearRegression> fit;
+    for (size_t j = 0; j < ts.size(); ++j) fit.addProfile(ts[j].size(), ts[j].data(), Ts[j].data());
+    fit.exec();
+
+    r = Stats::report();
+    CHECK(r[Stats::Integrations] > 0);
+    CHECK(r[Stats::ExpCalls] > r[Stats::Samples]);
+    CHECK(r[Stats::Samples] < 80 * r[Stats::Integrations]);
+  }
+}
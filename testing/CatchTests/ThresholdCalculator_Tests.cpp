@@ -1,7 +1,10 @@
 #include "catch.hpp"
 #include "fakeit.hpp"
 
+#include <cmath>
+#include <tuple>
 #include <vector>
+#include <boost/multiprecision/cpp_dec_float.hpp>
 #include <libArrhenius/Constants.hpp>
 #include <libArrhenius/Integration/ArrheniusIntegral.hpp>
 #include <libArrhenius/Integration/ModifiedArrheniusIntegral.hpp>
@@ -9,6 +12,7 @@
 
 using namespace libArrhenius;
 using namespace libArrhenius::Constants;
+using namespace boost::multiprecision;
 
 
 TEST_CASE( "ThresholdCalculator Usage", "[usage]" ) {
@@ -37,6 +41,18 @@ TEST_CASE( "ThresholdCalculator Usage", "[usage]" ) {
   double threshold = calc(N,t.data(),T.data());
 
   CHECK( threshold == Approx( (Ea/(MKS::R*log(A*tau)) - 310) / 10) );
+
+  PreparedProfile<double> profile(N,t.data(),T.data());
+  CHECK( calc(profile) == Approx( threshold ) );
+  CHECK( calc.Omega(profile) == Approx( calc.Omega(N,t.data(),T.data()) ) );
+
+  // a workspace can be reused for profiles of any size
+  ThresholdCalculator< ArrheniusIntegral<double> >::Workspace ws;
+  CHECK( calc(N,t.data(),T.data(),ws) == Approx( threshold ) );
+  CHECK( ws.dT.size() == N );
+  CHECK( calc(N/2,t.data(),T.data(),ws) == Approx( calc(N/2,t.data(),T.data()) ) );
+  CHECK( calc(profile,ws) == Approx( threshold ) );
+  CHECK( ws.dT.size() == N );
 }
 
 TEST_CASE( "ThresholdCalculator with Modified Arrhenius Integral", "[usage]" ) {
@@ -70,3 +86,123 @@ TEST_CASE( "ThresholdCalculator with Modified Arrhenius Integral", "[usage]" ) {
   threshold = calc(N,t.data(),T.data());
   CHECK( threshold < (Ea/(MKS::R*log(A*tau)) - 310) / 10 );
 }
+
+TEST_CASE( "ThresholdCalculator Halley Solver", "[usage]" ) {
+
+  size_t N = 1000;
+  std::vector<double> t(N), T(N), dT(N);
+
+  for( size_t i = 0; i < t.size(); i++ )
+  {
+    t[i] = 0.01*i;
+    T[i] = 310 + 20*exp(-pow((t[i]-5)/2,2));
+    dT[i] = T[i] - T[0];
+  }
+
+  double A = 3.1e99;
+  double Ea = 6.28e5;
+
+  SECTION("Derivatives")
+  {
+    ArrheniusIntegral<double> integrate(A,Ea);
+    std::vector<double> TT(N);
+    auto Omega = [&](double x){
+      for( size_t i = 0; i < N; i++ )
+        TT[i] = T[0] + x*dT[i];
+      return integrate(N,t.data(),TT.data());
+    };
+
+    double x = 1.5, h = 1e-4;
+    auto r = integrate.scaledLogOmega(N,t.data(),T[0],x,dT.data());
+    CHECK( std::get<0>(r) == Approx( log(Omega(x)) ) );
+    CHECK( std::get<1>(r) == Approx( (log(Omega(x+h)) - log(Omega(x-h)))/(2*h) ).epsilon(1e-6) );
+    CHECK( std::get<2>(r) == Approx( (log(Omega(x+h)) - 2*log(Omega(x)) + log(Omega(x-h)))/(h*h) ).epsilon(1e-4) );
+
+    // the temperature goes negative
+    CHECK( std::isnan( std::get<0>(integrate.scaledLogOmega(N,t.data(),T[0],-100,dT.data())) ) );
+  }
+
+  SECTION("No Threshold")
+  {
+    // the baseline temperature alone causes more damage than this
+    ThresholdCalculator< ArrheniusIntegral<double> > calc(A,Ea);
+    calc.setThresholdOmega(1e-20);
+    CHECK_THROWS( calc(N,t.data(),T.data()) );
+  }
+
+  SECTION("Arrhenius")
+  {
+    ThresholdCalculator< ArrheniusIntegral<double> > calc(A,Ea);
+    REQUIRE( calc.getUseDerivatives() );
+    double threshold = calc(N,t.data(),T.data());
+    calc.setUseDerivatives(false);
+    CHECK( threshold == Approx( calc(N,t.data(),T.data()) ).epsilon(1e-12) );
+
+    calc.setThresholdOmega(1e-3);
+    calc.setUseDerivatives(true);
+    threshold = calc(N,t.data(),T.data());
+    calc.setUseDerivatives(false);
+    CHECK( threshold == Approx( calc(N,t.data(),T.data()) ).epsilon(1e-12) );
+  }
+
+  SECTION("Modified Arrhenius")
+  {
+    ThresholdCalculator< ModifiedArrheniusIntegral<double> > calc(A,Ea,1);
+    double threshold = calc(N,t.data(),T.data());
+    calc.setUseDerivatives(false);
+    CHECK( threshold == Approx( calc(N,t.data(),T.data()) ).epsilon(1e-12) );
+  }
+
+  SECTION("Multiprecision")
+  {
+    std::vector<cpp_dec_float_100> tm(t.begin(),t.end()), Tm(T.begin(),T.end());
+    ThresholdCalculator< ArrheniusIntegral<cpp_dec_float_100> > calc(A,Ea);
+    cpp_dec_float_100 threshold = calc(N,tm.data(),Tm.data());
+    calc.setUseDerivatives(false);
+    CHECK( static_cast<double>(threshold/calc(N,tm.data(),Tm.data())) == Approx(1).epsilon(1e-12) );
+  }
+}
+
+TEST_CASE( "ThresholdCalculator Batch", "[usage]" ) {
+
+  std::vector<double> taus = {0.001, 0.01, 0.1, 1.0, 10.0};
+  ProfileSet<double> profiles;
+  std::vector<PreparedProfile<double>> prepared;
+
+  for( auto tau : taus )
+  {
+    double dt = tau / 20;
+    size_t N = 4*tau / dt;
+    std::vector<double> t(N), T(N);
+    for( size_t i = 0; i < N; i++ )
+    {
+      t[i] = dt*i;
+      T[i] = 310;
+      if( t[i] > tau/2 )
+        T[i] = 10 + 310;
+      if( t[i] > tau + tau/2 )
+        T[i] = 310;
+    }
+    profiles.addProfile(N,t.data(),T.data());
+    prepared.emplace_back(N,t.data(),T.data());
+  }
+
+  double A = 3.1e99;
+  double Ea = 6.28e5;
+  ThresholdCalculator< ArrheniusIntegral<double> > calc(A,Ea);
+
+  auto thresholds = calc(profiles);
+  REQUIRE( thresholds.size() == taus.size() );
+  for( size_t i = 0; i < taus.size(); ++i )
+  {
+    CHECK( thresholds[i] == Approx( (Ea/(MKS::R*log(A*taus[i])) - 310) / 10) );
+    CHECK( thresholds[i] == calc(profiles.N(i),profiles.t(i),profiles.T(i)) );
+  }
+
+  CHECK( calc(prepared) == thresholds );
+
+  // a profile without a threshold makes the whole batch throw
+  std::vector<double> t = {0, 1, 2}, T = {310, 310, 310};
+  profiles.addProfile(3,t.data(),T.data());
+  CHECK_THROWS( calc(profiles) );
+}
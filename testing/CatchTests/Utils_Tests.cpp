@@ -1,7 +1,16 @@
 #include "catch.hpp"
 #include "fakeit.hpp"
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 #include <libArrhenius/Utils/LinearRegression.hpp>
+#include <libArrhenius/Utils/ReadFunction.hpp>
+#include <libArrhenius/Utils/BoundedQueue.hpp>
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
 
 TEST_CASE( "Linear Regression Function", "[utils]" ) {
 
@@ -38,4 +47,162 @@ TEST_CASE( "Linear Regression Function", "[utils]" ) {
 
 
 
+}
+
+TEST_CASE( "Read Function", "[utils]" ) {
+
+  std::string text = "# time temperature\n"
+                     "0 310\n"
+                     "\n"
+                     "  0.5\t+3.2e2 extra\r\n"
+                     "1.0,330\n"
+                     "   # indented comment\n"
+                     "1.5 -1e-3";
+
+  SECTION("Pointers")
+  {
+    std::istringstream in(text);
+    double *t, *T;
+    int n;
+    RUC::ReadFunction(in, t, T, n);
+    REQUIRE( n == 4 );
+    CHECK( t[0] == 0 );
+    CHECK( t[1] == 0.5 );
+    CHECK( t[2] == 1.0 );
+    CHECK( t[3] == 1.5 );
+    CHECK( T[0] == 310 );
+    CHECK( T[1] == 320 );
+    CHECK( T[2] == 330 );
+    CHECK( T[3] == -1e-3 );
+    delete[] t;
+    delete[] T;
+  }
+
+  SECTION("Vectors")
+  {
+    std::istringstream in(text);
+    std::vector<float> t, T;
+    RUC::ReadFunction(in, t, T);
+    REQUIRE( t.size() == 4 );
+    REQUIRE( T.size() == 4 );
+    CHECK( t[1] == 0.5f );
+    CHECK( T[3] == -1e-3f );
+  }
+
+  SECTION("Multiplicity")
+  {
+    std::istringstream in("1 2 3\n4 5 6\n");
+    std::vector<double> x, y;
+    RUC::ReadFunction(in, x, y, 2);
+    REQUIRE( x.size() == 2 );
+    REQUIRE( y.size() == 4 );
+    CHECK( x[1] == 4 );
+    CHECK( y[0] == 2 );
+    CHECK( y[3] == 6 );
+  }
+
+  SECTION("Multiprecision")
+  {
+    typedef boost::multiprecision::cpp_dec_float_100 Real;
+    std::istringstream in(text);
+    std::vector<Real> t, T;
+    RUC::ReadFunction(in, t, T);
+    REQUIRE( t.size() == 4 );
+    CHECK( t[1] == Real("0.5") );
+    CHECK( T[3] == Real("-1e-3") );
+  }
+
+  SECTION("Long Lines")
+  {
+    // lines that cross the boundaries of the read buffer.
+    std::ostringstream out;
+    size_t N = 100000;
+    for(size_t i = 0; i < N; i++)
+      out << i << std::string(i%7 + 1, ' ') << (i%1000)*0.25 << "\n";
+    std::istringstream in(out.str());
+    std::vector<double> t, T;
+    RUC::ReadFunction(in, t, T);
+    REQUIRE( t.size() == N );
+    for(size_t i = 0; i < N; i += 997)
+    {
+      CHECK( t[i] == i );
+      CHECK( T[i] == (i%1000)*0.25 );
+    }
+  }
+
+  SECTION("File")
+  {
+    std::string filename = "Read_Function_Test.txt";
+    {
+      std::ofstream out(filename);
+      out << text;
+    }
+    std::vector<double> t, T;
+    RUC::ReadFunction(filename, t, T);
+    REQUIRE( t.size() == 4 );
+    CHECK( t[3] == 1.5 );
+    CHECK( T[3] == -1e-3 );
+
+    {
+      std::ofstream out(filename);
+    }
+    // the points are appended, and an empty file doesn't have any.
+    RUC::ReadFunction(filename, t, T);
+    CHECK( t.size() == 4 );
+
+    std::remove(filename.c_str());
+    CHECK_THROWS_AS( RUC::ReadFunction(filename, t, T), std::runtime_error );
+  }
+
+  SECTION("Errors")
+  {
+    std::vector<double> t, T;
+    std::istringstream missing("0 310\n1\n");
+    CHECK_THROWS_AS( RUC::ReadFunction(missing, t, T), std::runtime_error );
+    std::istringstream bad("0 310\n1 abc\n");
+    CHECK_THROWS_AS( RUC::ReadFunction(bad, t, T), std::runtime_error );
+  }
+}
+
+TEST_CASE( "Bounded Queue", "[utils]" ) {
+
+  SECTION("Producer and Consumer")
+  {
+    RUC::BoundedQueue<int> queue(3);
+    int N = 1000;
+    std::thread producer( [&](){
+        for(int i = 0; i < N; i++)
+          queue.push(i);
+        queue.close();
+        } );
+
+    int item, count = 0;
+    bool in_order = true;
+    while( queue.pop(item) )
+    {
+      in_order = in_order && item == count;
+      count++;
+    }
+    producer.join();
+    CHECK( count == N );
+    CHECK( in_order );
+  }
+
+  SECTION("Close")
+  {
+    RUC::BoundedQueue<int> queue(1);
+    CHECK( queue.push(1) );
+    // a producer blocked on a full queue is released when the queue is closed.
+    bool pushed = true;
+    std::thread producer( [&](){ pushed = queue.push(2); } );
+    queue.close();
+    producer.join();
+    CHECK( !pushed );
+
+    // items that were already in the queue can still be popped.
+    int item = 0;
+    CHECK( queue.pop(item) );
+    CHECK( item == 1 );
+    CHECK( !queue.pop(item) );
+  }
 }
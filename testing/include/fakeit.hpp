@@ -8314,7 +8314,7 @@ namespace fakeit {
 
             virtual ~StubbingChange() THROWS {
 
-                if (std::uncaught_exception()) {
+                if (std::uncaught_exceptions() > 0) {
                     return;
                 }
 
@@ -8574,7 +8574,7 @@ namespace fakeit {
         friend class SequenceVerificationProgress;
 
         ~SequenceVerificationExpectation() THROWS {
-            if (std::uncaught_exception()) {
+            if (std::uncaught_exceptions() > 0) {
                 return;
             }
             VerifyExpectation(_fakeit);
@@ -8936,7 +8936,7 @@ namespace fakeit {
             friend class VerifyNoOtherInvocationsVerificationProgress;
 
             ~VerifyNoOtherInvocationsExpectation() THROWS {
-                if (std::uncaught_exception()) {
+                if (std::uncaught_exceptions() > 0) {
                     return;
                 }
 